@@ -1,84 +0,0 @@
-#pragma once
-#include "ht16k33_char.h"
-
-namespace esphome {
-namespace ht16k33_char {
-
-class Adafruit14Seg : public HT16k33CharComponent {
- public:
-  Adafruit14Seg() {
-    this->num_chars_per_display_ = 4;
-    this->char_map_.insert({
-        {" ", 0b0000000000000000}, {"!", 0b0000000000000110}, {"\"", 0b0000001000100000}, {"#", 0b0001001011001110},
-        {"$", 0b0001001011101101}, {"%", 0b0000110000100100}, {"&", 0b0010001101011101},  {"\'", 0b0000010000000000},
-        {"(", 0b0010010000000000}, {")", 0b0000100100000000}, {"*", 0b0011111111000000},  {"+", 0b0001001011000000},
-        {",", 0b0000100000000000}, {"-", 0b0000000011000000}, {"/", 0b0000110000000000},  {"0", 0b0000110000111111},
-        {"1", 0b0000000000000110}, {"2", 0b0000000011011011}, {"3", 0b0000000010001111},  {"4", 0b0000000011100110},
-        {"5", 0b0010000001101001}, {"6", 0b0000000011111101}, {"7", 0b0001010000000001},  {"8", 0b0000000011111111},
-        {"9", 0b0000000011101111}, {":", 0b0001001000000000}, {";", 0b0000101000000000},  {"<", 0b0010010000000000},
-        {"=", 0b0000000011001000}, {">", 0b0000100100000000}, {"?", 0b0001000010000011},  {"@", 0b0000001010111011},
-        {"A", 0b0000000011110111}, {"B", 0b0001001010001111}, {"C", 0b0000000000111001},  {"D", 0b0001001000001111},
-        {"E", 0b0000000011111001}, {"F", 0b0000000001110001}, {"G", 0b0000000010111101},  {"H", 0b0000000011110110},
-        {"I", 0b0001001000000000}, {"J", 0b0000000000011110}, {"K", 0b0010010001110000},  {"L", 0b0000000000111000},
-        {"M", 0b0000010100110110}, {"N", 0b0010000100110110}, {"O", 0b0000000000111111},  {"P", 0b0000000011110011},
-        {"Q", 0b0010000000111111}, {"R", 0b0010000011110011}, {"S", 0b0000000011101101},  {"T", 0b0001001000000001},
-        {"U", 0b0000000000111110}, {"V", 0b0000110000110000}, {"W", 0b0010100000110110},  {"X", 0b0010110100000000},
-        {"Y", 0b0001010100000000}, {"Z", 0b0000110000001001}, {"[", 0b0000000000111001},  {"\\", 0b0010000100000000},
-        {"]", 0b0000000000001111}, {"^", 0b0000000000100011}, {"_", 0b0000000000001000},  {"`", 0b0000000100000000},
-        {"a", 0b0001000001011000}, {"b", 0b0010000001111000}, {"c", 0b0000000011011000},  {"d", 0b0000100010001110},
-        {"e", 0b0000100001011000}, {"f", 0b0000000001110001}, {"g", 0b0000000110001111},  {"h", 0b0001000001110000},
-        {"i", 0b0001000000000000}, {"j", 0b0000000000001110}, {"k", 0b0011011000000000},  {"l", 0b0000000000110000},
-        {"m", 0b0001000011010100}, {"n", 0b0001000001010000}, {"o", 0b0000000011011100},  {"p", 0b0000010001110001},
-        {"q", 0b0010000011100011}, {"r", 0b0000000001010000}, {"s", 0b0010000010001000},  {"t", 0b0000000001111000},
-        {"u", 0b0000000000011100}, {"v", 0b0010000000000100}, {"w", 0b0010100000010100},  {"x", 0b0010100011000000},
-        {"y", 0b0000001010001110}, {"z", 0b0000100001001000}, {"{", 0b0000100101001001},  {"|", 0b0001001000000000},
-        {"}", 0b0010010010001001}, {"~", 0b0000000011000000},
-    });
-  }
-
- protected:
-  uint8_t digit_map_[4] = {1, 3, 5, 7};
-  uint8_t handle_special_char(char char_to_find, uint8_t position) override;
-  void write_to_buffer(uint16_t char_to_write, uint8_t char_position) override;
-};
-
-class Adafruit14SegFlip : public HT16k33CharComponent {
- public:
-  Adafruit14SegFlip() {
-    this->num_chars_per_display_ = 4;
-    this->char_map_.insert({
-        {" ", 0b0000000000000000}, {"!", 0b0000000000110000}, {"\"", 0b0001000000000100}, {"#", 0b0001001011110001},
-        {"$", 0b0001001011101101}, {"%", 0b0000110000100100}, {"&", 0b0011000110101011},  {"\'", 0b0000100000000000},
-        {"(", 0b0000100100000000}, {")", 0b0010010000000000}, {"*", 0b0011111111000000},  {"+", 0b0001001011000000},
-        {",", 0b0000010000000000}, {"-", 0b0000000011000000}, {"/", 0b0000110000000000},  {"0", 0b0000110000111111},
-        {"1", 0b0000000000110000}, {"2", 0b0000000011011011}, {"3", 0b0000000001111001},  {"4", 0b0000000011110100},
-        {"5", 0b0000000110001101}, {"6", 0b0000000011101111}, {"7", 0b0000101000001000},  {"8", 0b0000000011111111},
-        {"9", 0b0000000011111101}, {":", 0b0001001000000000}, {";", 0b0001010000000000},  {"<", 0b0000100100000000},
-        {"=", 0b0000000011000001}, {">", 0b0010010000000000}, {"?", 0b0000001001011000},  {"@", 0b0001000001011111},
-        {"A", 0b0000000011111110}, {"B", 0b0001001001111001}, {"C", 0b0000000000001111},  {"D", 0b0001001000111001},
-        {"E", 0b0000000011001111}, {"F", 0b0000000010001110}, {"G", 0b0000000001101111},  {"H", 0b0000000011110110},
-        {"I", 0b0001001000000000}, {"J", 0b0000000000110011}, {"K", 0b0000100110000110},  {"L", 0b0000000000000111},
-        {"M", 0b0010100000110110}, {"N", 0b0010000100110110}, {"O", 0b0000000000111111},  {"P", 0b0000000011011110},
-        {"Q", 0b0000000100111111}, {"R", 0b0000000111011110}, {"S", 0b0000000011101101},  {"T", 0b0001001000001000},
-        {"U", 0b0000000000110111}, {"V", 0b0000110000000110}, {"W", 0b0000010100110110},  {"X", 0b0010110100000000},
-        {"Y", 0b0010101000000000}, {"Z", 0b0000110000001001}, {"[", 0b0000000000001111},  {"\\", 0b0010000100000000},
-        {"]", 0b0000000000111001}, {"^", 0b0000000000011100}, {"_", 0b0000000000000001},  {"`", 0b0010000000000000},
-        {"a", 0b0000001010000011}, {"b", 0b0000000110000111}, {"c", 0b0000000011000011},  {"d", 0b0000010001110001},
-        {"e", 0b0000010010000011}, {"f", 0b0000000010001110}, {"g", 0b0010000001111001},  {"h", 0b0000001010000110},
-        {"i", 0b0000001000000000}, {"j", 0b0000000000110001}, {"k", 0b0001101100000000},  {"l", 0b0000000000000110},
-        {"m", 0b0000001011100010}, {"n", 0b0000001010000010}, {"o", 0b0000000011100011},  {"p", 0b0000100010001110},
-        {"q", 0b0000000111011100}, {"r", 0b0000000010000010}, {"s", 0b0000000101000001},  {"t", 0b0000000010000111},
-        {"u", 0b0000000000100011}, {"v", 0b0000000100100000}, {"w", 0b0000010100100010},  {"x", 0b0000010111000000},
-        {"y", 0b0001000001110001}, {"z", 0b0000010010000001}, {"{", 0b0010010010001001},  {"|", 0b0001001000000000},
-        {"}", 0b0000100101001001}, {"~", 0b0000000011000000},
-    });
-  }
-
- protected:
-  uint8_t digit_map_[4] = {7, 5, 3, 1};
-  uint8_t handle_special_char(char char_to_find, uint8_t position) override;
-  void write_to_buffer(uint16_t char_to_write, uint8_t char_position) override;
-};
-
-}  // namespace ht16k33_char
-}  // namespace esphome
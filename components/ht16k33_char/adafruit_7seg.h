@@ -1,101 +0,0 @@
-#pragma once
-
-#include "ht16k33_char.h"
-
-namespace esphome {
-namespace ht16k33_char {
-
-class Adafruit7Seg : public HT16k33CharComponent {
- public:
-  Adafruit7Seg() {
-    this->num_chars_per_display_ = 4;
-    this->char_map_.insert({
-        {"0", 0b0000000000111111}, {"1", 0b0000000000000110}, {"2", 0b0000000001011011}, {"3", 0b0000000001001111},
-        {"4", 0b0000000001100110}, {"5", 0b0000000001101101}, {"6", 0b0000000001111101}, {"7", 0b0000000000000111},
-        {"8", 0b0000000001111111}, {"9", 0b0000000001101111}, {" ", 0b0000000000000000}, {"A", 0b0000000001110111},
-        {"b", 0b0000000001111100}, {"C", 0b0000000000111001}, {"c", 0b0000000001011000}, {"d", 0b0000000001011110},
-        {"E", 0b0000000001111001}, {"F", 0b0000000001110001}, {"G", 0b0000000000111101}, {"H", 0b0000000001110110},
-        {"h", 0b0000000001110100}, {"I", 0b0000000000110000}, {"J", 0b0000000000001110}, {"L", 0b0000000000111000},
-        {"N", 0b0000000000110111}, {"O", 0b0000000000111111}, {"o", 0b0000000001011100}, {"P", 0b0000000001110011},
-        {"r", 0b0000000001010000}, {"S", 0b0000000001101101}, {"t", 0b0000000001111000}, {"U", 0b0000000000111110},
-        {"u", 0b0000000000011100}, {"Y", 0b0000000001101110},
-    });
-  }
-
- protected:
-  uint8_t digit_map_[4] = {1, 3, 7, 9};
-  uint8_t handle_special_char(char char_to_find, uint8_t position) override;
-  void write_to_buffer(uint16_t char_to_write, uint8_t char_position) override;
-};
-
-class Adafruit7SegFlip : public HT16k33CharComponent {
- public:
-  Adafruit7SegFlip() {
-    this->num_chars_per_display_ = 4;
-    this->char_map_.insert({
-        {"0", 0b0000000000111111}, {"1", 0b0000000000110000}, {"2", 0b0000000001011011}, {"3", 0b0000000001111001},
-        {"4", 0b0000000001110100}, {"5", 0b0000000001101101}, {"6", 0b0000000001101111}, {"7", 0b0000000000111000},
-        {"8", 0b0000000001111111}, {"9", 0b0000000001111101}, {" ", 0b0000000000000000}, {"A", 0b0000000001111110},
-        {"b", 0b0000000001100111}, {"C", 0b0000000000001111}, {"c", 0b0000000001000011}, {"d", 0b0000000001110011},
-        {"E", 0b0000000001001111}, {"F", 0b0000000001001110}, {"G", 0b0000000000101111}, {"H", 0b0000000001110110},
-        {"h", 0b0000000001100110}, {"I", 0b0000000000000110}, {"J", 0b0000000000110001}, {"L", 0b0000000000000111},
-        {"N", 0b0000000000111110}, {"O", 0b0000000000111111}, {"o", 0b0000000001100011}, {"P", 0b0000000001011110},
-        {"r", 0b0000000001000010}, {"S", 0b0000000001101101}, {"t", 0b0000000001000111}, {"U", 0b0000000000110111},
-        {"u", 0b0000000000100011}, {"Y", 0b0000000001110101},
-    });
-  }
-
- protected:
-  uint8_t digit_map_[4] = {9, 7, 3, 1};
-  uint8_t handle_special_char(char char_to_find, uint8_t position) override;
-  void write_to_buffer(uint16_t char_to_write, uint8_t char_position) override;
-};
-
-class Adafruit7SegLarge : public HT16k33CharComponent {
- public:
-  Adafruit7SegLarge() {
-    this->num_chars_per_display_ = 4;
-    this->char_map_.insert({
-        {"0", 0b0000000000111111}, {"1", 0b0000000000000110}, {"2", 0b0000000001011011}, {"3", 0b0000000001001111},
-        {"4", 0b0000000001100110}, {"5", 0b0000000001101101}, {"6", 0b0000000001111101}, {"7", 0b0000000000000111},
-        {"8", 0b0000000001111111}, {"9", 0b0000000001101111}, {" ", 0b0000000000000000}, {"A", 0b0000000001110111},
-        {"b", 0b0000000001111100}, {"C", 0b0000000000111001}, {"c", 0b0000000001011000}, {"d", 0b0000000001011110},
-        {"E", 0b0000000001111001}, {"F", 0b0000000001110001}, {"G", 0b0000000000111101}, {"H", 0b0000000001110110},
-        {"h", 0b0000000001110100}, {"I", 0b0000000000110000}, {"J", 0b0000000000001110}, {"L", 0b0000000000111000},
-        {"N", 0b0000000000110111}, {"O", 0b0000000000111111}, {"o", 0b0000000001011100}, {"P", 0b0000000001110011},
-        {"r", 0b0000000001010000}, {"S", 0b0000000001101101}, {"t", 0b0000000001111000}, {"U", 0b0000000000111110},
-        {"u", 0b0000000000011100}, {"Y", 0b0000000001101110},
-    });
-  }
-
- protected:
-  uint8_t digit_map_[4] = {1, 3, 7, 9};
-  uint8_t handle_special_char(char char_to_find, uint8_t position) override;
-  void write_to_buffer(uint16_t char_to_write, uint8_t char_position) override;
-};
-
-class Adafruit7SegLargeFlip : public HT16k33CharComponent {
- public:
-  Adafruit7SegLargeFlip() {
-    this->num_chars_per_display_ = 4;
-    this->char_map_.insert({
-        {"0", 0b0000000000111111}, {"1", 0b0000000000110000}, {"2", 0b0000000001011011}, {"3", 0b0000000001111001},
-        {"4", 0b0000000001110100}, {"5", 0b0000000001101101}, {"6", 0b0000000001101111}, {"7", 0b0000000000111000},
-        {"8", 0b0000000001111111}, {"9", 0b0000000001111101}, {" ", 0b0000000000000000}, {"A", 0b0000000001111110},
-        {"b", 0b0000000001100111}, {"C", 0b0000000000001111}, {"c", 0b0000000001000011}, {"d", 0b0000000001110011},
-        {"E", 0b0000000001001111}, {"F", 0b0000000001001110}, {"G", 0b0000000000101111}, {"H", 0b0000000001110110},
-        {"h", 0b0000000001100110}, {"I", 0b0000000000000110}, {"J", 0b0000000000110001}, {"L", 0b0000000000000111},
-        {"N", 0b0000000000111110}, {"O", 0b0000000000111111}, {"o", 0b0000000001100011}, {"P", 0b0000000001011110},
-        {"r", 0b0000000001000010}, {"S", 0b0000000001101101}, {"t", 0b0000000001000111}, {"U", 0b0000000000110111},
-        {"u", 0b0000000000100011}, {"Y", 0b0000000001110101},
-    });
-  }
-
- protected:
-  uint8_t digit_map_[4] = {9, 7, 3, 1};
-  uint8_t handle_special_char(char char_to_find, uint8_t position) override;
-  void write_to_buffer(uint16_t char_to_write, uint8_t char_position) override;
-};
-
-}  // namespace ht16k33_char
-}  // namespace esphome
@@ -0,0 +1,51 @@
+import esphome.codegen as cg
+from esphome.components import binary_sensor
+import esphome.config_validation as cv
+from esphome.const import CONF_KEY
+import esphome.final_validate as fv
+
+from .display import (
+    CONF_SECONDARY_DISPLAYS,
+    HT16k33Char_BaseClassType,
+    ht16k33_char_ns,
+)
+
+CONF_HT16K33_CHAR_ID = "ht16k33_char_id"
+CONF_CHIP = "chip"
+
+HT16k33Key = ht16k33_char_ns.class_("HT16k33Key", binary_sensor.BinarySensor)
+
+# Keys are numbered (common * 13) + (K - 1), so K1 of KS0 is key 0 and K13 of KS2 is key 38. The chip is the index of
+# the chip in the display chain. The primary display is chip 0, followed by the secondary displays in order, so the
+# display decides how many chips there are.
+CONFIG_SCHEMA = binary_sensor.binary_sensor_schema(HT16k33Key).extend(
+    {
+        cv.GenerateID(CONF_HT16K33_CHAR_ID): cv.use_id(HT16k33Char_BaseClassType),
+        cv.Optional(CONF_CHIP, default=0): cv.uint8_t,
+        cv.Required(CONF_KEY): cv.int_range(min=0, max=38),
+    }
+)
+
+
+def final_validate_chip(config):
+    full_config = fv.full_config.get()
+    display_path = full_config.get_path_for_id(config[CONF_HT16K33_CHAR_ID])[:-1]
+    display_config = full_config.get_config_for_path(display_path)
+    num_chips = 1 + len(display_config.get(CONF_SECONDARY_DISPLAYS, []))
+    if config[CONF_CHIP] >= num_chips:
+        raise cv.Invalid(
+            f"chip must be less than {num_chips}, the number of displays of {config[CONF_HT16K33_CHAR_ID]}",
+            path=[CONF_CHIP],
+        )
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = final_validate_chip
+
+
+async def to_code(config):
+    var = await binary_sensor.new_binary_sensor(config)
+    parent = await cg.get_variable(config[CONF_HT16K33_CHAR_ID])
+    cg.add(var.set_chip(config[CONF_CHIP]))
+    cg.add(var.set_key(config[CONF_KEY]))
+    cg.add(parent.register_key(var))
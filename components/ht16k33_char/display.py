@@ -1,16 +1,36 @@
+from esphome import automation, pins
 import esphome.codegen as cg
-from esphome.components import display, i2c
+from esphome.components import display, i2c, sensor
+from esphome.components import time as time_
 import esphome.config_validation as cv
 from esphome.const import (
+    CONF_ADDRESS,
     CONF_BRIGHTNESS,
+    CONF_CHANNEL,
     CONF_CONTINUOUS,
     CONF_DEVICE,
+    CONF_FORMAT,
+    CONF_I2C_ID,
     CONF_ID,
+    CONF_INTERRUPT_PIN,
     CONF_LAMBDA,
+    CONF_SENSOR,
+    CONF_TEXT,
+    CONF_TIME_ID,
+    CONF_TRIGGER_ID,
+    CONF_VALUE,
+    UNIT_MILLISECOND,
+    UNIT_PERCENT,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
 )
+from esphome.core import CORE, ID, HexInt
 
 DEPENDENCIES = ["i2c"]
 
+DOMAIN = "ht16k33_char"
+
 ht16k33_char_ns = cg.esphome_ns.namespace("ht16k33_char")
 
 CONF_MAX_BUFFER_LENGTH = "max_buffer_length"
@@ -18,18 +38,157 @@ CONF_SCROLL = "scroll"
 CONF_SCROLL_SPEED = "scroll_speed"
 CONF_SCROLL_DWELL = "scroll_dwell"
 CONF_SCROLL_DELAY = "scroll_delay"
+CONF_SCROLL_CATCH_UP = "scroll_catch_up"
 CONF_SECONDARY_DISPLAYS = "secondary_displays"
+CONF_MULTIPLEXER_ADDRESS = "multiplexer_address"
+CONF_STREAM_LENGTH = "stream_length"
+CONF_STREAM_DROP_POLICY = "stream_drop_policy"
+CONF_MAX_BYTES_PER_LOOP = "max_bytes_per_loop"
+CONF_KEY_SCAN_INTERVAL = "key_scan_interval"
+CONF_KEY_DEBOUNCE = "key_debounce"
+CONF_ON_KEY = "on_key"
+CONF_TRANSITION = "transition"
+CONF_TRANSITION_DURATION = "transition_duration"
+CONF_PLAYLIST = "playlist"
+CONF_DWELL = "dwell"
+CONF_REFRESH = "refresh"
+CONF_CLOCK = "clock"
+CONF_LEADING_ZERO = "leading_zero"
+CONF_BLINK_COLON = "blink_colon"
+CONF_AUTO_BRIGHTNESS = "auto_brightness"
+CONF_CURVE = "curve"
+CONF_HYSTERESIS = "hysteresis"
+CONF_STEP_INTERVAL = "step_interval"
+
+CONF_FRAMES = "frames"
+CONF_BYTES_WRITTEN = "bytes_written"
+CONF_TRANSACTIONS = "transactions"
+CONF_WRITE_ERRORS = "write_errors"
+CONF_UPDATE_TIME = "update_time"
+CONF_MAX_UPDATE_TIME = "max_update_time"
+CONF_WRITER_TIME = "writer_time"
+CONF_MAX_WRITER_TIME = "max_writer_time"
+CONF_SCROLL_RATE = "scroll_rate"
+CONF_SCROLL_JITTER = "scroll_jitter"
+CONF_SKIP_RATIO = "skip_ratio"
+CONF_STREAM_DROPPED = "stream_dropped"
+
+UNIT_MICROSECOND = "µs"
+UNIT_STEPS_PER_SECOND = "steps/s"
 
 CONF_ADD_CHARACTERS = "add_characters"
 CONF_REMOVE_CHARACTERS = "remove_characters"
 
-CONFIG_SECONDARY = cv.Schema({cv.GenerateID(): cv.declare_id(i2c.I2CDevice)}).extend(
-    i2c.i2c_device_schema(None)
+# The transitions that can be shown when the message changes. The values are the HT16K33_TRANSITION_* constants.
+TRANSITION_TYPES = {
+    "NONE": 0,
+    "WIPE": 1,
+    "BUILD": 2,
+    "FADE": 3,
+    "FLASH": 4,
+}
+
+# What happens to text pushed to a full stream.
+STREAM_DROP_POLICIES = {
+    "DROP_NEWEST": 0,
+    "DROP_OLDEST": 1,
+}
+
+# When the lambda of a playlist entry runs.
+REFRESH_POLICIES = {
+    "ALWAYS": 0,
+    "ON_SHOW": 1,
+    "ONCE": 2,
+}
+
+# One message of the playlist. `scroll` defaults to the `scroll` option of the display.
+PLAYLIST_ENTRY_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Optional(CONF_LAMBDA): cv.lambda_,
+            cv.Optional(CONF_TEXT): cv.string,
+            cv.Optional(CONF_DWELL, default="5s"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_SCROLL): cv.boolean,
+            cv.Optional(CONF_REFRESH, default="ALWAYS"): cv.enum(
+                REFRESH_POLICIES, upper=True
+            ),
+        }
+    ),
+    cv.has_exactly_one_key(CONF_LAMBDA, CONF_TEXT),
+)
+
+# The strftime conversions that show the seconds. A clock that uses any of them is updated
+#   every second, otherwise every minute.
+CLOCK_SECONDS_CONVERSIONS = ("%S", "%T", "%r", "%X", "%c", "%s")
+
+CLOCK_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_TIME_ID): cv.use_id(time_.RealTimeClock),
+        cv.Optional(CONF_FORMAT, default="%H:%M"): cv.string,
+        cv.Optional(CONF_LEADING_ZERO, default=True): cv.boolean,
+        cv.Optional(CONF_BLINK_COLON, default=False): cv.boolean,
+    }
 )
 
+
+def validate_brightness_curve(value):
+    values = [point[CONF_VALUE] for point in value]
+    if any(a >= b for a, b in zip(values, values[1:])):
+        raise cv.Invalid("The values of the curve must be in increasing order")
+    return value
+
+
+# Sets the brightness from a sensor. The readings are mapped to a brightness through
+#   the curve, which is linear between its points. The hysteresis is in brightness steps.
+AUTO_BRIGHTNESS_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_SENSOR): cv.use_id(sensor.Sensor),
+        cv.Optional(
+            CONF_CURVE,
+            default=[
+                {CONF_VALUE: 0, CONF_BRIGHTNESS: 1},
+                {CONF_VALUE: 500, CONF_BRIGHTNESS: 16},
+            ],
+        ): cv.All(
+            cv.ensure_list(
+                cv.Schema(
+                    {
+                        cv.Required(CONF_VALUE): cv.float_,
+                        cv.Required(CONF_BRIGHTNESS): cv.float_range(min=1, max=16),
+                    }
+                )
+            ),
+            cv.Length(min=1),
+            validate_brightness_curve,
+        ),
+        cv.Optional(CONF_HYSTERESIS, default=0.25): cv.float_range(min=0, max=8),
+        cv.Optional(
+            CONF_STEP_INTERVAL, default="250ms"
+        ): cv.positive_time_period_milliseconds,
+    }
+)
+
+# A secondary display can be on a channel of the TCA9548A multiplexer set with
+#   `multiplexer_address`. The multiplexer must be on the bus of the primary display.
+CONFIG_SECONDARY = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(i2c.I2CDevice),
+        cv.Optional(CONF_CHANNEL): cv.int_range(min=0, max=7),
+    }
+).extend(i2c.i2c_device_schema(None))
+
+HT16K33_NO_CHANNEL = ht16k33_char_ns.HT16K33_NO_CHANNEL
+
 HT16k33Char_BaseClassType = ht16k33_char_ns.class_(
     "HT16k33CharComponent", cg.PollingComponent, i2c.I2CDevice
 )
+# The component class is this template, instantiated with the struct that holds the layout table of the device.
+HT16k33CharDevice = ht16k33_char_ns.class_(
+    "HT16k33CharDevice", HT16k33Char_BaseClassType
+)
+HT16k33KeyTrigger = ht16k33_char_ns.class_(
+    "HT16k33KeyTrigger", automation.Trigger.template(cg.uint8, cg.uint8)
+)
 
 
 # Formatting functions. These functions convert the input character codes to the proper format for the various devices.
@@ -110,6 +269,70 @@ def validate_added_chars(value_to_validate):
     return value_to_validate
 
 
+def validate_multiplexer(config):
+    # Displays on a multiplexer channel need the multiplexer.
+    if CONF_MULTIPLEXER_ADDRESS in config:
+        if config[CONF_MULTIPLEXER_ADDRESS] == config[CONF_ADDRESS]:
+            raise cv.Invalid(
+                "multiplexer_address can't be the address of the primary display"
+            )
+        # A full frame also needs the channel select, and one byte is kept back to release the channels.
+        if config.get(CONF_MAX_BYTES_PER_LOOP, 18) < 18:
+            raise cv.Invalid(
+                "max_bytes_per_loop must be at least 18 with multiplexer_address"
+            )
+        return config
+    for conf in config.get(CONF_SECONDARY_DISPLAYS, []):
+        if CONF_CHANNEL in conf:
+            raise cv.Invalid(
+                "secondary displays with a channel need multiplexer_address"
+            )
+    return config
+
+
+def final_validate_multiplexer(config):
+    # The i2c_id of each display is only resolved to its bus once the whole config is read, so the buses are compared
+    # here instead of in validate_multiplexer().
+    if CONF_MULTIPLEXER_ADDRESS not in config:
+        return config
+    primary_bus = config[CONF_I2C_ID].id
+    direct = {config[CONF_ADDRESS]}
+    behind = set()
+    for conf in config.get(CONF_SECONDARY_DISPLAYS, []):
+        on_primary_bus = conf[CONF_I2C_ID].id == primary_bus
+        if CONF_CHANNEL not in conf:
+            if on_primary_bus:
+                direct.add(conf[CONF_ADDRESS])
+        elif on_primary_bus:
+            behind.add(conf[CONF_ADDRESS])
+        else:
+            # The multiplexer is driven on the bus of the primary display.
+            raise cv.Invalid(
+                "secondary displays with a channel must be on the bus of the primary display"
+            )
+    # The displays that are not behind the multiplexer are accessed without switching the channels, so a chip on a
+    #   channel must not answer to their addresses.
+    shared = direct & behind
+    if shared:
+        raise cv.Invalid(
+            f"secondary displays with a channel can't use address 0x{min(shared):02X}, "
+            "which a display that is not behind the multiplexer uses"
+        )
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = final_validate_multiplexer
+
+
+def validate_stream(config):
+    # The stream scrolls by itself. It can't also scroll like a message.
+    if CONF_STREAM_LENGTH in config and (
+        config[CONF_SCROLL] or config[CONF_CONTINUOUS]
+    ):
+        raise cv.Invalid("stream_length can't be used with scroll or continuous")
+    return config
+
+
 def validate_removed_chars(value_to_validate):
     if not isinstance(value_to_validate, list):
         # If the entry is not a list, make it into a list.
@@ -126,60 +349,499 @@ def validate_removed_chars(value_to_validate):
     return value_to_validate
 
 
+# Fonts. The character codes are in the standard format used by the `add_characters` config option. The
+#   `FORMAT_FUNCTION` of the device type is used to convert them to the format of the device.
+FONT_7_SEG = {
+    "0": 0b0000000000111111,
+    "1": 0b0000000000000110,
+    "2": 0b0000000001011011,
+    "3": 0b0000000001001111,
+    "4": 0b0000000001100110,
+    "5": 0b0000000001101101,
+    "6": 0b0000000001111101,
+    "7": 0b0000000000000111,
+    "8": 0b0000000001111111,
+    "9": 0b0000000001101111,
+    " ": 0b0000000000000000,
+    "A": 0b0000000001110111,
+    "b": 0b0000000001111100,
+    "C": 0b0000000000111001,
+    "c": 0b0000000001011000,
+    "d": 0b0000000001011110,
+    "E": 0b0000000001111001,
+    "F": 0b0000000001110001,
+    "G": 0b0000000000111101,
+    "H": 0b0000000001110110,
+    "h": 0b0000000001110100,
+    "I": 0b0000000000110000,
+    "J": 0b0000000000001110,
+    "L": 0b0000000000111000,
+    "N": 0b0000000000110111,
+    "O": 0b0000000000111111,
+    "o": 0b0000000001011100,
+    "P": 0b0000000001110011,
+    "r": 0b0000000001010000,
+    "S": 0b0000000001101101,
+    "t": 0b0000000001111000,
+    "U": 0b0000000000111110,
+    "u": 0b0000000000011100,
+    "Y": 0b0000000001101110,
+}
+
+FONT_14_SEG = {
+    " ": 0b0000000000000000,
+    "!": 0b0000000000000110,
+    '"': 0b0000001000100000,
+    "#": 0b0001001011001110,
+    "$": 0b0001001011101101,
+    "%": 0b0000110000100100,
+    "&": 0b0010001101011101,
+    "'": 0b0000010000000000,
+    "(": 0b0010010000000000,
+    ")": 0b0000100100000000,
+    "*": 0b0011111111000000,
+    "+": 0b0001001011000000,
+    ",": 0b0000100000000000,
+    "-": 0b0000000011000000,
+    "/": 0b0000110000000000,
+    "0": 0b0000110000111111,
+    "1": 0b0000000000000110,
+    "2": 0b0000000011011011,
+    "3": 0b0000000010001111,
+    "4": 0b0000000011100110,
+    "5": 0b0010000001101001,
+    "6": 0b0000000011111101,
+    "7": 0b0001010000000001,
+    "8": 0b0000000011111111,
+    "9": 0b0000000011101111,
+    ":": 0b0001001000000000,
+    ";": 0b0000101000000000,
+    "<": 0b0010010000000000,
+    "=": 0b0000000011001000,
+    ">": 0b0000100100000000,
+    "?": 0b0001000010000011,
+    "@": 0b0000001010111011,
+    "A": 0b0000000011110111,
+    "B": 0b0001001010001111,
+    "C": 0b0000000000111001,
+    "D": 0b0001001000001111,
+    "E": 0b0000000011111001,
+    "F": 0b0000000001110001,
+    "G": 0b0000000010111101,
+    "H": 0b0000000011110110,
+    "I": 0b0001001000000000,
+    "J": 0b0000000000011110,
+    "K": 0b0010010001110000,
+    "L": 0b0000000000111000,
+    "M": 0b0000010100110110,
+    "N": 0b0010000100110110,
+    "O": 0b0000000000111111,
+    "P": 0b0000000011110011,
+    "Q": 0b0010000000111111,
+    "R": 0b0010000011110011,
+    "S": 0b0000000011101101,
+    "T": 0b0001001000000001,
+    "U": 0b0000000000111110,
+    "V": 0b0000110000110000,
+    "W": 0b0010100000110110,
+    "X": 0b0010110100000000,
+    "Y": 0b0001010100000000,
+    "Z": 0b0000110000001001,
+    "[": 0b0000000000111001,
+    "\\": 0b0010000100000000,
+    "]": 0b0000000000001111,
+    "^": 0b0000000000100011,
+    "_": 0b0000000000001000,
+    "`": 0b0000000100000000,
+    "a": 0b0001000001011000,
+    "b": 0b0010000001111000,
+    "c": 0b0000000011011000,
+    "d": 0b0000100010001110,
+    "e": 0b0000100001011000,
+    "f": 0b0000000001110001,
+    "g": 0b0000000110001111,
+    "h": 0b0001000001110000,
+    "i": 0b0001000000000000,
+    "j": 0b0000000000001110,
+    "k": 0b0011011000000000,
+    "l": 0b0000000000110000,
+    "m": 0b0001000011010100,
+    "n": 0b0001000001010000,
+    "o": 0b0000000011011100,
+    "p": 0b0000010001110001,
+    "q": 0b0010000011100011,
+    "r": 0b0000000001010000,
+    "s": 0b0010000010001000,
+    "t": 0b0000000001111000,
+    "u": 0b0000000000011100,
+    "v": 0b0010000000000100,
+    "w": 0b0010100000010100,
+    "x": 0b0010100011000000,
+    "y": 0b0000001010001110,
+    "z": 0b0000100001001000,
+    "{": 0b0000100101001001,
+    "|": 0b0001001000000000,
+    "}": 0b0010010010001001,
+    "~": 0b0000000011000000,
+}
+
+
+# The special character types. These match the SPECIAL_CHAR_* constants in ht16k33_char.h.
+SPECIAL_CHAR_POSITIONAL = 0x01
+SPECIAL_CHAR_ATTACH_PREVIOUS = 0x02
+SPECIAL_CHAR_ATTACH_NEXT = 0x03
+
+# A bit of the character code that does not light a segment.
+SEGMENT_NONE = 0xFF
+
+
+def direct_segments(mask):
+    # Bit n of the character code lights bit n % 8 of byte n // 8 of the digit, if it is in mask.
+    return [n if mask & (1 << n) else SEGMENT_NONE for n in range(16)]
+
+
+# The layouts describe where the characters are drawn in the display RAM of each device. A layout is a dictionary
+#   with the keys:
+#     `DIGITS`: The frame index of each digit. Index 1 is the first byte of the display RAM.
+#     `DIGIT_SHIFTS`: Optional, the number of bits that the segments of each digit are shifted by.
+#     `SEGMENTS`: For each bit of the character code, the segment it lights relative to the digit, as
+#                 (byte << 3) | bit. SEGMENT_NONE if the bit does not light a segment.
+#     `SPECIAL_CHARS`: The characters that are not in the font, but light a segment of the display. The value is
+#                      either (SPECIAL_CHAR_ATTACH_PREVIOUS or SPECIAL_CHAR_ATTACH_NEXT, bits), where the bits are
+#                      added to the character code of the digit before or after the character, or a dictionary of
+#                      the positions where the character is valid, as position: (frame index, bits). The position
+#                      is the number of the digit after the character.
+
+# Adafruit 7 segment .56" displays
+#   Product Link: https://www.adafruit.com/product/878
+#   Schematic: https://learn.adafruit.com/assets/108790
+#   Display Datasheet: https://cdn-shop.adafruit.com/datasheets/865datasheet.pdf
+#
+#   These devices are mostly only able to display numbers. There are a few letters in the font set that display
+#   reasonably well on the 7 segment display. Bit 7 is the decimal point. On the flipped display it is at the top
+#   left of the digit, so it is used for apostrophes. The colon between digits 2 and 3 can't be used together with
+#   the period after digit 2.
+LAYOUT_ADAFRUIT_7_SEG = {
+    "DIGITS": [1, 3, 7, 9],
+    "SEGMENTS": direct_segments(0x00FF),
+    "SPECIAL_CHARS": {
+        ".": (SPECIAL_CHAR_ATTACH_PREVIOUS, 0x80),
+        ":": {2: (5, 0b00000010)},
+    },
+}
+LAYOUT_ADAFRUIT_7_SEG_FLIP = {
+    "DIGITS": [9, 7, 3, 1],
+    "SEGMENTS": direct_segments(0x00FF),
+    "SPECIAL_CHARS": {
+        "'": (SPECIAL_CHAR_ATTACH_NEXT, 0x80),
+        "`": (SPECIAL_CHAR_ATTACH_NEXT, 0x80),
+        ":": {2: (5, 0b00000010)},
+    },
+}
+
+# Adafruit 7 segment 1.2" displays
+#   Product Link: https://www.adafruit.com/product/1270
+#   Schematic: https://learn.adafruit.com/assets/122068
+#   Display Datasheet: https://cdn-shop.adafruit.com/datasheets/1264datasheet.pdf
+#
+#   As of this writing (3/2025) the schematic for this device linked above is wrong. The LEDs segments are connected
+#   to the HT16K33 the same as the .56" devices. This display doesnt have a decimal point after each digit. In
+#   addition to the four 7-segment digits, it has four other dots controlled by bits in frame index 5:
+#     0b00000010 - A colon between digits 2 and 3.
+#     0b00000100 - The upper part of the colon at the left edge of the display.
+#     0b00001000 - The lower part of the colon at the left edge of the display.
+#     0b00010000 - A dot between digits 3 and 4 at the top. Could be a decimal point if the display was flipped
+#                  upside-down.
+#   A colon or an apostrophe that can't be shown on the right side up display is dropped.
+LAYOUT_ADAFRUIT_7_SEG_LARGE_APOSTROPHE = {
+    0: (5, 0b00000100),
+    1: (5, 0),
+    2: (5, 0),
+    3: (5, 0b00010000),
+    4: (5, 0),
+}
+LAYOUT_ADAFRUIT_7_SEG_LARGE = {
+    "DIGITS": [1, 3, 7, 9],
+    "SEGMENTS": direct_segments(0x007F),
+    "SPECIAL_CHARS": {
+        ":": {
+            0: (5, 0b00001100),
+            1: (5, 0),
+            2: (5, 0b00000010),
+            3: (5, 0),
+            4: (5, 0),
+        },
+        "'": LAYOUT_ADAFRUIT_7_SEG_LARGE_APOSTROPHE,
+        "`": LAYOUT_ADAFRUIT_7_SEG_LARGE_APOSTROPHE,
+        ".": {0: (5, 0b00001000)},
+    },
+}
+LAYOUT_ADAFRUIT_7_SEG_LARGE_FLIP = {
+    "DIGITS": [9, 7, 3, 1],
+    "SEGMENTS": direct_segments(0x007F),
+    "SPECIAL_CHARS": {
+        ":": {2: (5, 0b00000010), 4: (5, 0b00001100)},
+        "'": {4: (5, 0b00001000)},
+        "`": {4: (5, 0b00001000)},
+        ".": {1: (5, 0b00010000), 4: (5, 0b00000100)},
+    },
+}
+
+# Adafruit 14 segment .56" displays
+#   Product Link: https://www.adafruit.com/product/1911
+#   Schematic: https://learn.adafruit.com/assets/114463
+#   Display Datasheet: https://cdn-shop.adafruit.com/datasheets/CID2379.pdf
+#
+#   These devices can display pretty much all of the ASCII characters. Bit 14 is the decimal point. On the flipped
+#   display it is at the top left of the digit. Both apostrophes are in the default font, so on the flipped display
+#   they only light the decimal point if they are removed with `remove_characters`.
+LAYOUT_ADAFRUIT_14_SEG = {
+    "DIGITS": [1, 3, 5, 7],
+    "SEGMENTS": direct_segments(0x7FFF),
+    "SPECIAL_CHARS": {
+        ".": (SPECIAL_CHAR_ATTACH_PREVIOUS, 0x4000),
+    },
+}
+LAYOUT_ADAFRUIT_14_SEG_FLIP = {
+    "DIGITS": [7, 5, 3, 1],
+    "SEGMENTS": direct_segments(0x7FFF),
+    "SPECIAL_CHARS": {
+        "'": (SPECIAL_CHAR_ATTACH_NEXT, 0x4000),
+        "`": (SPECIAL_CHAR_ATTACH_NEXT, 0x4000),
+    },
+}
+
+# Sparkfun 14 segment QWIIC displays
+#   Product Link: https://www.sparkfun.com/sparkfun-qwiic-alphanumeric-display-red.html
+#   Schematic: https://cdn.sparkfun.com/assets/c/7/2/8/a/Qwiic_Alphanumeric_Display.pdf
+#   Display Datasheet: https://cdn.sparkfun.com/assets/c/8/7/2/5/VK16K33Datasheet.pdf
+#
+#   These devices can display pretty much all of the ASCII characters. The digits share the bytes of the display
+#   RAM: Bit n of the character code is in byte 2 * (n % 8) of the display RAM, at bit 0 of the digit for n < 8 and
+#   bit 4 for n >= 8. The bits of digit d are shifted by d. On the flipped display, the colon between digits 2 and 3
+#   is shown, and the period at the top of the display between digits 1 and 2 is not used.
+SEGMENTS_SPARKFUN_14_SEG = [((2 * (n % 8)) << 3) | (4 * (n // 8)) for n in range(16)]
+LAYOUT_SPARKFUN_14_SEG = {
+    "DIGITS": [1, 1, 1, 1],
+    "DIGIT_SHIFTS": [0, 1, 2, 3],
+    "SEGMENTS": SEGMENTS_SPARKFUN_14_SEG,
+    "SPECIAL_CHARS": {
+        ":": {2: (2, 0x01)},
+        ".": {3: (4, 0x01)},
+    },
+}
+LAYOUT_SPARKFUN_14_SEG_FLIP = {
+    "DIGITS": [1, 1, 1, 1],
+    "DIGIT_SHIFTS": [3, 2, 1, 0],
+    "SEGMENTS": SEGMENTS_SPARKFUN_14_SEG,
+    "SPECIAL_CHARS": {
+        ":": {2: (2, 0x01)},
+    },
+}
+
 # A dictionary for supported device types:
 #  -The key is what the user would put in the YAML file to select this device.
 #  -The value is a dictionary that contains the keys:
-#     `CLASS_NAME`: The name of the class that implements the device.
+#     `LAYOUT`: Where the characters are drawn in the display RAM of the device.
 #     `FORMAT_FUNCTION`: A python function defined in this file that converts
 #                        a digit code from the standard format to whatever
 #                        format the device expects.
+#     `FONT`: The font for the device, in the standard format.
 HT16K33_DEVICE_TYPES = {
     "ADAFRUIT_7_SEG_1.2IN": {
-        "CLASS_NAME": "Adafruit7SegLarge",
+        "LAYOUT": LAYOUT_ADAFRUIT_7_SEG_LARGE,
         "FORMAT_FUNCTION": format_none,
+        "FONT": FONT_7_SEG,
     },
     "ADAFRUIT_7_SEG_1.2IN_FLIPPED": {
-        "CLASS_NAME": "Adafruit7SegLargeFlip",
+        "LAYOUT": LAYOUT_ADAFRUIT_7_SEG_LARGE_FLIP,
         "FORMAT_FUNCTION": format_7seg_flip,
+        "FONT": FONT_7_SEG,
     },
     "ADAFRUIT_7_SEG_.56IN": {
-        "CLASS_NAME": "Adafruit7Seg",
+        "LAYOUT": LAYOUT_ADAFRUIT_7_SEG,
         "FORMAT_FUNCTION": format_none,
+        "FONT": FONT_7_SEG,
     },
     "ADAFRUIT_7_SEG_.56IN_FLIPPED": {
-        "CLASS_NAME": "Adafruit7SegFlip",
+        "LAYOUT": LAYOUT_ADAFRUIT_7_SEG_FLIP,
         "FORMAT_FUNCTION": format_7seg_flip,
+        "FONT": FONT_7_SEG,
     },
     "ADAFRUIT_14_SEG": {
-        "CLASS_NAME": "Adafruit14Seg",
+        "LAYOUT": LAYOUT_ADAFRUIT_14_SEG,
         "FORMAT_FUNCTION": format_none,
+        "FONT": FONT_14_SEG,
     },
     "ADAFRUIT_14_SEG_FLIPPED": {
-        "CLASS_NAME": "Adafruit14SegFlip",
+        "LAYOUT": LAYOUT_ADAFRUIT_14_SEG_FLIP,
         "FORMAT_FUNCTION": format_14seg_flip,
+        "FONT": FONT_14_SEG,
     },
     "SPARKFUN_14_SEG": {
-        "CLASS_NAME": "Sparkfun14Seg",
+        "LAYOUT": LAYOUT_SPARKFUN_14_SEG,
         "FORMAT_FUNCTION": format_14seg_sparkfun,
+        "FONT": FONT_14_SEG,
     },
     "SPARKFUN_14_SEG_FLIPPED": {
-        "CLASS_NAME": "Sparkfun14SegFlip",
+        "LAYOUT": LAYOUT_SPARKFUN_14_SEG_FLIP,
         "FORMAT_FUNCTION": format_14seg_sparkfun_flip,
+        "FONT": FONT_14_SEG,
     },
 }
 
 HT16k33Char_BaseClassTypeRef = HT16k33Char_BaseClassType.operator("ref")
 
-CONFIG_SCHEMA = (
+
+def font_to_table(font):
+    # Converts a font dictionary to the flat table of 16-bit words that is read by the
+    #   C++ code. See the description of the font table in ht16k33_char.h.
+    ascii_codes = [0] * 128
+    ascii_bitmap = [0] * 8
+    extended = []
+    for char, code in font.items():
+        codepoint = ord(char)
+        if codepoint < 128:
+            ascii_codes[codepoint] = code
+            ascii_bitmap[codepoint // 16] |= 1 << (codepoint % 16)
+        else:
+            extended.append((codepoint, code))
+
+    table = ascii_codes + ascii_bitmap + [len(extended)]
+    for codepoint, code in sorted(extended):
+        table += [codepoint >> 16, codepoint & 0xFFFF, code]
+    return table
+
+
+def get_font_table(font):
+    # Returns the font table for the font, creating it if needed. Displays that end up
+    #   with the same font after adding and removing characters share one table.
+    fonts = CORE.data.setdefault(DOMAIN, {}).setdefault("fonts", {})
+    table = font_to_table(font)
+    key = tuple(table)
+    if key not in fonts:
+        font_id = ID(
+            f"ht16k33_char_font_{len(fonts)}", is_declaration=True, type=cg.uint16
+        )
+        fonts[key] = cg.progmem_array(font_id, [HexInt(word) for word in table])
+    return fonts[key]
+
+
+def layout_to_table(layout):
+    # Converts a layout dictionary to the flat table of 16-bit words that is read by the
+    #   C++ code. See the description of the layout tables in ht16k33_char.h.
+    digits = layout["DIGITS"]
+    shifts = layout.get("DIGIT_SHIFTS", [0] * len(digits))
+    table = [len(digits)]
+    table += [(shift << 8) | index for index, shift in zip(digits, shifts)]
+    table += layout["SEGMENTS"]
+    table += [len(layout["SPECIAL_CHARS"])]
+    for char, special in layout["SPECIAL_CHARS"].items():
+        if isinstance(special, dict):
+            table += [ord(char), SPECIAL_CHAR_POSITIONAL, 0]
+            for position in range(len(digits) + 1):
+                index, bits = special.get(position, (0, 0))
+                table += [(index << 8) | bits]
+        else:
+            char_type, bits = special
+            table += [ord(char), char_type, bits] + [0] * (len(digits) + 1)
+    return table
+
+
+def get_layout_type(layout):
+    # Returns the name of the struct that holds the layout table for the layout, creating it
+    #   if needed. HT16k33CharDevice is instantiated with it, so the table is unpacked and
+    #   the render loop is compiled for it at compile time.
+    layouts = CORE.data.setdefault(DOMAIN, {}).setdefault("layouts", {})
+    table = layout_to_table(layout)
+    key = tuple(table)
+    if key not in layouts:
+        name = f"ht16k33_char_layout_{len(layouts)}"
+        words = ", ".join(str(HexInt(word)) for word in table)
+        cg.add_global(
+            cg.RawStatement(
+                f"struct {name} {{\n  static constexpr uint16_t TABLE[] = {{{words}}};\n}};"
+            )
+        )
+        layouts[key] = name
+    return layouts[key]
+
+
+# Optional sensors that report the performance counters of the display. They need the
+#   sensor component, which is only loaded by configs that have sensors.
+COUNTER_SENSOR_SCHEMA = sensor.sensor_schema(
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+TIME_SENSOR_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_MICROSECOND,
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+STATS_SENSORS = {
+    CONF_FRAMES: COUNTER_SENSOR_SCHEMA,
+    CONF_BYTES_WRITTEN: COUNTER_SENSOR_SCHEMA,
+    CONF_TRANSACTIONS: COUNTER_SENSOR_SCHEMA,
+    CONF_WRITE_ERRORS: COUNTER_SENSOR_SCHEMA,
+    CONF_UPDATE_TIME: TIME_SENSOR_SCHEMA,
+    CONF_MAX_UPDATE_TIME: TIME_SENSOR_SCHEMA,
+    CONF_WRITER_TIME: TIME_SENSOR_SCHEMA,
+    CONF_MAX_WRITER_TIME: TIME_SENSOR_SCHEMA,
+    CONF_SCROLL_RATE: sensor.sensor_schema(
+        unit_of_measurement=UNIT_STEPS_PER_SECOND,
+        accuracy_decimals=1,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_SCROLL_JITTER: sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLISECOND,
+        accuracy_decimals=1,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # The share of the updates that found the displays already up to date, in %.
+    CONF_SKIP_RATIO: sensor.sensor_schema(
+        unit_of_measurement=UNIT_PERCENT,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # The characters that the stream dropped because it was full.
+    CONF_STREAM_DROPPED: COUNTER_SENSOR_SCHEMA,
+}
+
+CONFIG_SCHEMA = cv.All(
     display.BASIC_DISPLAY_SCHEMA.extend(
         {
             cv.GenerateID(): cv.declare_id(HT16k33Char_BaseClassType),
             cv.Required(CONF_DEVICE): cv.enum(HT16K33_DEVICE_TYPES, upper=True),
+            # The message, the compiled message and each playlist entry reserve room for
+            #   this many bytes, so long tickers cost RAM.
             cv.Optional(CONF_MAX_BUFFER_LENGTH, default=8): cv.int_range(
-                min=4, max=255
+                min=4, max=4096
             ),
             cv.Optional(CONF_BRIGHTNESS, default=15): cv.int_range(min=1, max=16),
+            cv.Optional(CONF_AUTO_BRIGHTNESS): AUTO_BRIGHTNESS_SCHEMA,
             cv.Optional(CONF_SECONDARY_DISPLAYS): cv.ensure_list(CONFIG_SECONDARY),
+            cv.Optional(CONF_MULTIPLEXER_ADDRESS): cv.All(
+                cv.i2c_address, cv.int_range(min=0x70, max=0x77)
+            ),
+            # A full frame is 16 bytes, so the limit can't be lower than that.
+            cv.Optional(CONF_MAX_BYTES_PER_LOOP): cv.int_range(min=16, max=65535),
+            # Keyscan. The INT pin is only used if keys are configured. Its interrupt
+            #   wakes the component when a key is pressed.
+            cv.Optional(CONF_INTERRUPT_PIN): pins.internal_gpio_input_pin_schema,
+            cv.Optional(
+                CONF_KEY_SCAN_INTERVAL, default="20ms"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_KEY_DEBOUNCE, default=2): cv.int_range(min=1, max=255),
+            cv.Optional(CONF_ON_KEY): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(HT16k33KeyTrigger),
+                }
+            ),
             cv.Optional(CONF_CONTINUOUS, default=False): cv.boolean,
             cv.Optional(CONF_SCROLL, default=False): cv.boolean,
             cv.Optional(
@@ -191,19 +853,45 @@ CONFIG_SCHEMA = (
             cv.Optional(
                 CONF_SCROLL_DELAY, default="5s"
             ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_SCROLL_CATCH_UP, default=False): cv.boolean,
+            cv.Optional(CONF_TRANSITION, default="NONE"): cv.enum(
+                TRANSITION_TYPES, upper=True
+            ),
+            cv.Optional(
+                CONF_TRANSITION_DURATION, default="500ms"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_PLAYLIST): cv.ensure_list(PLAYLIST_ENTRY_SCHEMA),
+            cv.Optional(CONF_CLOCK): CLOCK_SCHEMA,
+            # Streaming ticker. The stream scrolls at `scroll_speed`.
+            cv.Optional(CONF_STREAM_LENGTH): cv.int_range(min=1, max=4096),
+            cv.Optional(CONF_STREAM_DROP_POLICY, default="DROP_NEWEST"): cv.enum(
+                STREAM_DROP_POLICIES, upper=True
+            ),
             cv.Optional(CONF_ADD_CHARACTERS): validate_added_chars,
             cv.Optional(CONF_REMOVE_CHARACTERS): validate_removed_chars,
         }
     )
+    .extend(
+        {
+            cv.Optional(key): cv.All(schema, cv.requires_component("sensor"))
+            for key, schema in STATS_SENSORS.items()
+        }
+    )
     .extend(cv.polling_component_schema("10s"))
-    .extend(i2c.i2c_device_schema(0x70))
+    .extend(i2c.i2c_device_schema(0x70)),
+    # The playlist and the clock replace the lambda of the display.
+    cv.has_at_most_one_key(CONF_LAMBDA, CONF_PLAYLIST, CONF_CLOCK),
+    cv.has_at_most_one_key(CONF_STREAM_LENGTH, CONF_PLAYLIST, CONF_CLOCK),
+    validate_stream,
+    validate_multiplexer,
 )
 
 
 async def to_code(config):
-    ClassType = ht16k33_char_ns.class_(
-        HT16K33_DEVICE_TYPES[config[CONF_DEVICE]]["CLASS_NAME"],
-        HT16k33Char_BaseClassType,
+    ClassType = HT16k33CharDevice.template(
+        cg.RawExpression(
+            get_layout_type(HT16K33_DEVICE_TYPES[config[CONF_DEVICE]]["LAYOUT"])
+        )
     )
     ClassInstantiation = ClassType.new()
     var = cg.Pvariable(config[CONF_ID], ClassInstantiation, ClassType)
@@ -212,6 +900,37 @@ async def to_code(config):
     await display.register_display(var, config)
     cg.add(var.set_buffer_max_size(config[CONF_MAX_BUFFER_LENGTH]))
     cg.add(var.set_brightness(config[CONF_BRIGHTNESS]))
+    if CONF_AUTO_BRIGHTNESS in config:
+        conf = config[CONF_AUTO_BRIGHTNESS]
+        sens = await cg.get_variable(conf[CONF_SENSOR])
+        cg.add(var.set_auto_brightness_sensor(sens))
+        for point in conf[CONF_CURVE]:
+            cg.add(
+                var.add_auto_brightness_point(point[CONF_VALUE], point[CONF_BRIGHTNESS])
+            )
+        cg.add(var.set_auto_brightness_hysteresis(conf[CONF_HYSTERESIS]))
+        cg.add(var.set_auto_brightness_step_interval(conf[CONF_STEP_INTERVAL]))
+    if CONF_MAX_BYTES_PER_LOOP in config:
+        cg.add(var.set_max_bytes_per_loop(config[CONF_MAX_BYTES_PER_LOOP]))
+
+    cg.add(var.set_transition(config[CONF_TRANSITION]))
+    cg.add(var.set_transition_duration(config[CONF_TRANSITION_DURATION]))
+
+    if CONF_INTERRUPT_PIN in config:
+        pin = await cg.gpio_pin_expression(config[CONF_INTERRUPT_PIN])
+        cg.add(var.set_interrupt_pin(pin))
+    cg.add(var.set_key_scan_interval(config[CONF_KEY_SCAN_INTERVAL]))
+    cg.add(var.set_key_debounce(config[CONF_KEY_DEBOUNCE]))
+    for conf in config.get(CONF_ON_KEY, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(
+            trigger, [(cg.uint8, "chip"), (cg.uint8, "key")], conf
+        )
+
+    for key in STATS_SENSORS:
+        if key in config:
+            sens = await sensor.new_sensor(config[key])
+            cg.add(getattr(var, f"set_{key}_sensor")(sens))
 
     if CONF_LAMBDA in config:
         lambda_ = await cg.process_lambda(
@@ -221,30 +940,87 @@ async def to_code(config):
         )
         cg.add(var.set_writer(lambda_))
 
-    if config[CONF_SCROLL]:
-        cg.add(var.set_scroll(True))
+    playlist = config.get(CONF_PLAYLIST, [])
+    for conf in playlist:
+        scroll = conf.get(CONF_SCROLL, config[CONF_SCROLL])
+        if CONF_LAMBDA in conf:
+            lambda_ = await cg.process_lambda(
+                conf[CONF_LAMBDA],
+                [(HT16k33Char_BaseClassTypeRef, "it")],
+                return_type=cg.void,
+            )
+            cg.add(
+                var.add_playlist_entry(
+                    lambda_, conf[CONF_DWELL], scroll, conf[CONF_REFRESH]
+                )
+            )
+        else:
+            cg.add(var.add_playlist_entry(conf[CONF_TEXT], conf[CONF_DWELL], scroll))
+
+    # The scroll settings are also needed if only some playlist entries scroll.
+    if config[CONF_SCROLL] or any(conf.get(CONF_SCROLL, False) for conf in playlist):
+        cg.add(var.set_scroll(config[CONF_SCROLL]))
         cg.add(var.set_continuous(config[CONF_CONTINUOUS]))
         cg.add(var.set_scroll_speed(config[CONF_SCROLL_SPEED]))
         cg.add(var.set_scroll_dwell(config[CONF_SCROLL_DWELL]))
         cg.add(var.set_scroll_delay(config[CONF_SCROLL_DELAY]))
+        cg.add(var.set_scroll_catch_up(config[CONF_SCROLL_CATCH_UP]))
+
+    if CONF_CLOCK in config:
+        conf = config[CONF_CLOCK]
+        clock = await cg.get_variable(conf[CONF_TIME_ID])
+        cg.add(var.set_clock(clock))
+        cg.add(var.set_clock_format(conf[CONF_FORMAT]))
+        # "%%" is a literal percent sign, not the start of a conversion.
+        conversions = conf[CONF_FORMAT].replace("%%", "")
+        if any(conversion in conversions for conversion in CLOCK_SECONDS_CONVERSIONS):
+            cg.add(var.set_clock_period(1000))
+        else:
+            cg.add(var.set_clock_period(60000))
+        cg.add(var.set_clock_leading_zero(conf[CONF_LEADING_ZERO]))
+        cg.add(var.set_clock_blink_colon(conf[CONF_BLINK_COLON]))
+
+    if CONF_STREAM_LENGTH in config:
+        cg.add(var.set_stream_length(config[CONF_STREAM_LENGTH]))
+        cg.add(var.set_stream_drop_policy(config[CONF_STREAM_DROP_POLICY]))
+        cg.add(var.set_scroll_speed(config[CONF_SCROLL_SPEED]))
+        cg.add(var.set_scroll_catch_up(config[CONF_SCROLL_CATCH_UP]))
 
     if CONF_SECONDARY_DISPLAYS in config:
+        # Secondary displays can be on other buses than the primary display. Each bus
+        #   gets its own flush queue. The bus of the primary display is bus 0.
+        buses = [config[CONF_I2C_ID].id]
         for conf in config[CONF_SECONDARY_DISPLAYS]:
             disp = cg.new_Pvariable(conf[CONF_ID])
             await i2c.register_i2c_device(disp, conf)
-            cg.add(var.add_secondary_display(disp))
-
-    if CONF_ADD_CHARACTERS in config:
-        for char_to_add, value_to_add in config[CONF_ADD_CHARACTERS].items():
+            if conf[CONF_I2C_ID].id not in buses:
+                buses.append(conf[CONF_I2C_ID].id)
             cg.add(
-                var.add_char(
-                    char_to_add,
-                    HT16K33_DEVICE_TYPES[config[CONF_DEVICE]]["FORMAT_FUNCTION"](
-                        value_to_add
-                    ),
+                var.add_secondary_display(
+                    disp,
+                    conf.get(CONF_CHANNEL, HT16K33_NO_CHANNEL),
+                    buses.index(conf[CONF_I2C_ID].id),
                 )
             )
 
+    if CONF_MULTIPLEXER_ADDRESS in config:
+        cg.add(var.set_multiplexer_address(config[CONF_MULTIPLEXER_ADDRESS]))
+
+    # Build the font for this display. The character codes are converted to the device
+    #   format, then the characters from `add_characters` and `remove_characters` are
+    #   applied. The result is stored as a constant table in flash.
+    format_function = HT16K33_DEVICE_TYPES[config[CONF_DEVICE]]["FORMAT_FUNCTION"]
+    font = {
+        char: format_function(code)
+        for char, code in HT16K33_DEVICE_TYPES[config[CONF_DEVICE]]["FONT"].items()
+    }
+
+    if CONF_ADD_CHARACTERS in config:
+        for char_to_add, value_to_add in config[CONF_ADD_CHARACTERS].items():
+            font[char_to_add] = format_function(value_to_add)
+
     if CONF_REMOVE_CHARACTERS in config:
         for char_to_remove in config[CONF_REMOVE_CHARACTERS]:
-            cg.add(var.remove_char(char_to_remove))
+            font.pop(char_to_remove, None)
+
+    cg.add(var.set_font(get_font_table(font)))
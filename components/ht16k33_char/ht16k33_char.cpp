@@ -1,4 +1,8 @@
-#include <unordered_map>
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+#include <sys/time.h>
 
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
@@ -11,11 +15,10 @@
  *    -Add to the HT16K33_DEVICE_TYPES enum in the display.py file
  *    -If nessecary, add formatting functions to display.py that convert character codes from the
  *     standard format to the correct format for the new device.
- *    -Add a new .h and .c file that defines a class derived from the `HT16k33CharComponent` class.
- *     This class should:
- *      -Add the character codes to char_map_ during class initialization.
- *      -Implement a `uint8_t handle_special_char(char char_to_find, uint8_t position)` function.
- *      -Implement a `void write_to_buffer(uint16_t char_to_write, uint8_t char_position)'
+ *    -If none of the fonts in display.py work for the new device, add a new font to display.py.
+ *    -Add a layout to display.py that describes where the digits and special characters are in the display RAM.
+ *     The format of the layout tables is described in ht16k33_char.h. The component is HT16k33CharDevice
+ *     instantiated with the layout, so render_frame_() is compiled for it.
  */
 
 namespace esphome {
@@ -36,17 +39,72 @@ float HT16k33CharComponent::get_setup_priority() const { return setup_priority::
 
 void HT16k33CharComponent::setup() {
   ESP_LOGCONFIG(TAG, "Setting up HT16K33...");
-  uint8_t setup_buffer;
 
-  for (auto *display : this->displays_) {
-    setup_buffer = HT16K33_SYSTEM_SETUP | HT16K33_MODE_NORMAL;
-    display->write(&setup_buffer, 1);
-
-    setup_buffer = HT16K33_DISPLAY_SETUP | HT16K33_DISPLAY_ON;
-    display->write(&setup_buffer, 1);
+  // Access the chips grouped by bus, so that each bus gets its own flush queue, and then by multiplexer channel, so
+  // that each channel only has to be selected once per frame.
+  this->bus_order_.clear();
+  for (size_t i = 0; i < this->displays_.size(); i++) {
+    this->bus_order_.push_back(i);
+  }
+  std::stable_sort(this->bus_order_.begin(), this->bus_order_.end(), [this](uint8_t a, uint8_t b) {
+    if (this->displays_[a].bus != this->displays_[b].bus) {
+      return this->displays_[a].bus < this->displays_[b].bus;
+    }
+    return this->displays_[a].channel < this->displays_[b].channel;
+  });
+  this->bus_start_.assign(this->displays_[this->bus_order_.back()].bus + 2, 0);
+  for (auto &display : this->displays_) {
+    this->bus_start_[display.bus + 1]++;
+  }
+  for (size_t bus = 1; bus < this->bus_start_.size(); bus++) {
+    this->bus_start_[bus] += this->bus_start_[bus - 1];
+  }
+  this->flush_cursors_.assign(this->bus_start_.size() - 1, 0);
+  this->bus_budgets_.assign(this->bus_start_.size() - 1, 0);
+
+  for (auto &display : this->displays_) {
+    // We don't know what is in the display RAM or the control registers yet. Everything is sent on the first update.
+    display.ram_valid = false;
+    display.system_setup = 0;
+    display.display_setup = 0;
+    display.dimming = 0;
+    display.row_int = 0;
   }
 
+  // The control registers and the blank frames are sent by the first loop().
   this->brightness(this->brightness_);
+  this->setup_keyscan_();
+
+  if (this->transition_ != HT16K33_TRANSITION_NONE) {
+    // Enough room for the longest transition, so that the keyframes are never reallocated.
+    this->keyframes_.reserve((this->num_chars_per_display_ + 17) * this->displays_.size() + 32);
+  }
+
+  if (this->stream_length_ != 0) {
+    // This is the only allocation for the stream. It never grows.
+    this->stream_.init(this->stream_length_, this->stream_drop_policy_);
+  }
+
+  for (auto &entry : this->playlist_) {
+    // The entries keep their compiled message and frames while they are not shown. A text entry knows its message, so
+    // it reserves just the room for that now, and switching to it does not allocate. The message of a lambda is not
+    // known yet. Its entry grows to fit the longest message the lambda prints, and keeps that room.
+    if (!entry.writer.has_value()) {
+      size_t length = std::min<size_t>(entry.text.size(), this->char_buffer_max_size_);
+      entry.message.reserve(length);
+      entry.glyphs.reserve(length);
+    }
+    if (!entry.scroll) {
+      entry.frames.resize(this->displays_.size() * HT16K33_FRAME_SIZE);
+    }
+  }
+  if (!this->playlist_.empty()) {
+    this->scroll_ = this->playlist_[0].scroll;
+    // The entry that is shown brings its own compiled message, so the room that set_buffer_max_size() reserved for it
+    // is not needed.
+    std::string().swap(this->compiled_message_);
+    std::vector<HT16k33Glyph>().swap(this->glyphs_);
+  }
 
   this->blank();
   this->fist_char_location_ = 0;
@@ -63,68 +121,418 @@ void HT16k33CharComponent::setup() {
     this->scroll_state_ = HT16K33_SCROLL_STATE_FIRST_START;
     this->last_scroll_ = App.get_loop_component_start_time();
   }
+
+#ifdef USE_TIME
+  if (this->clock_ != nullptr) {
+    // The system clock jumps when the time is synced. Start over on the new period boundaries then.
+    this->clock_->add_on_time_sync_callback([this]() { this->clock_tick_(); });
+    this->clock_tick_();
+  }
+#endif
+
+#ifdef USE_SENSOR
+  if (this->auto_brightness_sensor_ != nullptr) {
+    this->auto_brightness_sensor_->add_on_state_callback(
+        [this](float value) { this->auto_brightness_reading_(value); });
+    if (this->auto_brightness_sensor_->has_state()) {
+      this->auto_brightness_reading_(this->auto_brightness_sensor_->get_state());
+    }
+  }
+#endif
 }
 
 void HT16k33CharComponent::update() {
+  if (!this->playlist_.empty()) {
+    HT16k33PlaylistEntry &entry = this->playlist_[this->playlist_index_];
+    if (!this->playlist_shown_) {
+      this->show_entry(this->playlist_index_);
+    } else if (entry.writer.has_value() && (entry.refresh == HT16K33_REFRESH_ALWAYS)) {
+      this->run_writer_(*entry.writer);
+      this->refresh_display_();
+    }
+  } else if (this->writer_.has_value()) {
+    // This checks if the lambda function is defined. If it is not defined, we don't do anything.
+    this->run_writer_(*this->writer_);
+    this->refresh_display_();
+  }
+
+  // update() only queues frames and register changes. loop() sends them, within its byte budget.
+  this->enable_loop();
+
+  this->log_stats_();
+  this->publish_stats_();
+}
+
+/***********************************
+ *Runs a lambda that prints the message, and records how long it took.
+ ************************************/
+void HT16k33CharComponent::run_writer_(ht16k33_char_writer_t &writer) {
+  uint32_t start_time;
+  uint32_t writer_time;
+
+  start_time = micros();
+  writer(*this);
+  writer_time = micros() - start_time;
+  this->stats_.writer_calls++;
+  this->stats_.writer_time_us += writer_time;
+  if (writer_time > this->stats_.max_writer_time_us) {
+    this->stats_.max_writer_time_us = writer_time;
+  }
+}
+
+/***********************************
+ *Shows the message after a lambda printed it.
+ ************************************/
+void HT16k33CharComponent::refresh_display_() {
   uint16_t current_buffer_location;
 
-  // This checks if the lambda function is defined. If it is not defined, we don't do anything.
-  if (this->writer_.has_value()) {
-    // This line is responsible for calling the lambda code.
-    (*this->writer_)(*this);
-
-    // The lambda code does not actually update the display directly. It manipulates the message buffer.
-    //   - If the display is static (no scrolling), we directly call display() to update the display now.
-    //   - If scrolling is happening, we do not update the display in this function. The display will
-    //     be updated in the loop() function.
-    //   - if we are in the state 'FIRST_START' this means we just started the device. In that state,
-    //     the display will not be showing anything yet, and we need to run the update_display()
-    //     function to show the initial contents.
-    if ((this->scroll_state_ == HT16K33_SCROLL_STATE_STATIC) ||
-        (this->scroll_state_ == HT16K33_SCROLL_STATE_FIRST_START) ||
-        (this->scroll_state_ == HT16K33_SCROLL_STATE_STOPPED)) {
-      this->last_scroll_ = App.get_loop_component_start_time();
-      current_buffer_location = this->update_display();
-
-      if ((this->fist_char_location_ == 0) && (current_buffer_location >= this->message_buffer_.length()) &&
-          (this->scroll_state_ == HT16K33_SCROLL_STATE_FIRST_START)) {
-        // We reached the end of the char buffer before we reached the end of the display.
-        this->scroll_state_ = HT16K33_SCROLL_STATE_STOPPED;
-      }
+  this->restart_scroll_();
+
+  // The lambda code does not actually update the display directly. It manipulates the message buffer.
+  //   - If the display is static (no scrolling), we directly call display() to update the display now.
+  //   - If scrolling is happening, we do not update the display in this function. The display will
+  //     be updated in the loop() function.
+  //   - if we are in the state 'FIRST_START' this means we just started the device. In that state,
+  //     the display will not be showing anything yet, and we need to run the update_display()
+  //     function to show the initial contents.
+  if ((this->scroll_state_ == HT16K33_SCROLL_STATE_STATIC) ||
+      (this->scroll_state_ == HT16K33_SCROLL_STATE_FIRST_START) ||
+      (this->scroll_state_ == HT16K33_SCROLL_STATE_STOPPED)) {
+    this->last_scroll_ = App.get_loop_component_start_time();
+    current_buffer_location = this->update_display();
+
+    if ((this->fist_char_location_ == 0) && (current_buffer_location >= this->glyphs_.size()) &&
+        (this->scroll_state_ == HT16K33_SCROLL_STATE_FIRST_START)) {
+      // We reached the end of the char buffer before we reached the end of the display.
+      this->scroll_state_ = HT16K33_SCROLL_STATE_STOPPED;
+    }
+  }
+
+  if (!this->playlist_.empty() && (this->scroll_state_ == HT16K33_SCROLL_STATE_STATIC) &&
+      (this->transition_ == HT16K33_TRANSITION_NONE)) {
+    // Keep the frames of the entry, so that they don't have to be rendered again the next time it is shown.
+    HT16k33PlaylistEntry &entry = this->playlist_[this->playlist_index_];
+    for (size_t chip = 0; chip < this->displays_.size(); chip++) {
+      memcpy(&entry.frames[chip * HT16K33_FRAME_SIZE], this->displays_[chip].frame, HT16K33_FRAME_SIZE);
+    }
+    entry.frames_valid = true;
+  }
+}
+
+/***********************************
+ *Shows an entry of the playlist now. The dwell time of the entry starts now.
+ *
+ *  index: the index of the entry. If it is past the end of the playlist, the playlist starts over.
+ ************************************/
+void HT16k33CharComponent::show_entry(size_t index) {
+  if (this->playlist_.empty()) {
+    return;
+  }
+  this->show_entry_(index % this->playlist_.size());
+  this->playlist_entry_start_ = App.get_loop_component_start_time();
+  this->enable_loop();
+}
+
+/***********************************
+ *Switches the displays to an entry of the playlist.
+ *
+ * The entry that was shown keeps its compiled message, and the entry that is shown takes its own back. This only
+ * swaps the buffers, so nothing is copied or allocated. The lambda of the entry runs as its refresh policy says. If
+ * the entry does not scroll and its message is the same as the last time it was shown, its frames are queued as they
+ * are, without compiling or rendering the message.
+ *
+ *  index: the index of the entry.
+ ************************************/
+void HT16k33CharComponent::show_entry_(size_t index) {
+  if (this->playlist_shown_) {
+    HT16k33PlaylistEntry &old_entry = this->playlist_[this->playlist_index_];
+    if (this->message_changed_ && (this->message_buffer_ != this->compiled_message_)) {
+      // The entry is left before its message was compiled, for example between two scroll steps. Compile it now, so
+      // that the entry takes the message it printed along.
+      this->compile_message_();
+    }
+    old_entry.glyphs.swap(this->glyphs_);
+    old_entry.message.swap(this->compiled_message_);
+  }
+
+  this->playlist_index_ = index;
+  this->playlist_shown_ = true;
+  HT16k33PlaylistEntry &entry = this->playlist_[index];
+  entry.glyphs.swap(this->glyphs_);
+  entry.message.swap(this->compiled_message_);
+  this->rendered_ = false;
+
+  // Each entry starts from the beginning of its message.
+  this->scroll_ = entry.scroll;
+  this->fist_char_location_ = 0;
+  this->last_scroll_ = App.get_loop_component_start_time();
+  if (!this->scroll_) {
+    this->scroll_state_ = HT16K33_SCROLL_STATE_STATIC;
+  } else if (this->continuous_) {
+    this->scroll_state_ = HT16K33_SCROLL_STATE_SCROLLING;
+  } else {
+    this->scroll_state_ = HT16K33_SCROLL_STATE_FIRST_START;
+  }
+
+  if (entry.writer.has_value() && ((entry.refresh != HT16K33_REFRESH_ONCE) || !entry.shown)) {
+    this->run_writer_(*entry.writer);
+  } else if (entry.writer.has_value()) {
+    // The lambda does not run again. The message it printed came back with the compiled message of the entry.
+    this->print(0, true, std::string_view(this->compiled_message_));
+  } else {
+    this->print(0, true, entry.text.c_str());
+  }
+  entry.shown = true;
+
+  if (entry.frames_valid && (this->scroll_state_ == HT16K33_SCROLL_STATE_STATIC) &&
+      (this->transition_ == HT16K33_TRANSITION_NONE) && (this->message_buffer_ == this->compiled_message_)) {
+    for (size_t chip = 0; chip < this->displays_.size(); chip++) {
+      memcpy(this->displays_[chip].frame, &entry.frames[chip * HT16K33_FRAME_SIZE], HT16K33_FRAME_SIZE);
+      this->displays_[chip].frame_pending = true;
     }
+    this->message_changed_ = false;
+    this->enable_loop();
+    return;
+  }
+
+  this->refresh_display_();
+}
+
+/***********************************
+ *Moves on to the next entry of the playlist when the dwell time of the entry that is shown is over. This is called
+ * from loop().
+ ************************************/
+void HT16k33CharComponent::run_playlist_() {
+  uint32_t start;
+
+  if ((this->playlist_.size() < 2) || !this->playlist_shown_) {
+    return;
   }
+
+  // Like the scroll steps, the next entry is timed from when this one was due, so the playlist does not drift.
+  start = this->playlist_entry_start_;
+  if ((App.get_loop_component_start_time() - start) < this->playlist_[this->playlist_index_].dwell) {
+    return;
+  }
+  start += this->playlist_[this->playlist_index_].dwell;
+  this->show_entry_((this->playlist_index_ + 1) % this->playlist_.size());
+  this->playlist_entry_start_ = start;
 }
 
 void HT16k33CharComponent::loop() {
+  uint32_t start_time = micros();
+  uint32_t loop_time;
+
+  this->reset_budgets_();
+
+  this->run_playlist_();
+  this->update_scroll_();
+  this->run_transition_();
+
+  // Everything above only queues. This is the only place that the displays are accessed, so the byte budget covers
+  // all of it. The oscillator has to run before the frames are shown, so the control registers go first.
+  // A key scan that ran out of budget goes before the frames in the next loop(), so that a scrolling display can't
+  // hold the keys up.
+  this->commit_registers_();
+  if (this->key_scan_running_) {
+    this->scan_keys_();
+    this->flush_displays_();
+  } else {
+    this->flush_displays_();
+    this->scan_keys_();
+  }
+  this->release_channel_();
+
+  this->schedule_loop_();
+
+  loop_time = micros() - start_time;
+  if (loop_time > this->stats_.max_loop_time_us) {
+    this->stats_.max_loop_time_us = loop_time;
+  }
+}
+
+/****************************
+ *Returns the time left until a period that started at `start` is over, or 0 if it is over.
+ ****************************/
+static uint32_t time_left(uint32_t now, uint32_t start, uint32_t period) {
+  uint32_t elapsed = now - start;
+  return (elapsed >= period) ? 0 : (period - elapsed);
+}
+
+/****************************
+ *Turns off loop() until there is something for it to do. If something is due later, such as the next scroll step,
+ * the next keyframe of a transition or the next key scan, a timeout turns loop() back on at that time. Anything
+ * that gives loop() more work, such as update() or a change to the control registers, turns it back on right away.
+ ****************************/
+void HT16k33CharComponent::schedule_loop_() {
+  uint32_t now = App.get_loop_component_start_time();
+  uint32_t wait = UINT32_MAX;
+
+  if (this->registers_changed_ || this->key_scan_running_) {
+    // Register writes and key scans that did not fit in the byte budget continue in the next loop.
+    return;
+  }
+  for (auto &display : this->displays_) {
+    if (display.frame_pending) {
+      // Frames that did not fit in the byte budget are sent in the next loop.
+      return;
+    }
+  }
+
+  if (this->stream_length_ != 0) {
+    // The stream scrolls while there is anything in it.
+    if (!this->stream_.empty()) {
+      wait = time_left(now, this->last_scroll_, this->scroll_speed_);
+    }
+  }
+  if (this->transition_running_()) {
+    // The scroll is held until the transition is over.
+    wait = std::min(wait, time_left(now, this->transition_start_, this->keyframes_[this->next_keyframe_].time));
+  } else {
+    switch (this->scroll_state_) {
+      case HT16K33_SCROLL_STATE_START:
+      case HT16K33_SCROLL_STATE_FIRST_START:
+        wait = time_left(now, this->last_scroll_, this->scroll_delay_);
+        break;
+      case HT16K33_SCROLL_STATE_SCROLLING:
+        wait = time_left(now, this->last_scroll_, this->scroll_speed_);
+        break;
+      case HT16K33_SCROLL_STATE_END:
+        wait = time_left(now, this->last_scroll_, this->scroll_dwell_);
+        break;
+    }
+  }
+
+  if (this->keyscan_ && ((this->interrupt_pin_ == nullptr) || this->keys_settling_ || this->key_interrupt_)) {
+    // With the INT pin, the keys are only scanned on a schedule until they settle. Then the interrupt wakes loop().
+    wait = std::min(wait, time_left(now, this->last_key_scan_, this->key_scan_interval_));
+  }
+
+  if ((this->playlist_.size() > 1) && this->playlist_shown_) {
+    wait = std::min(wait, time_left(now, this->playlist_entry_start_, this->playlist_[this->playlist_index_].dwell));
+  }
+
+  if (wait == 0) {
+    // Something is due already.
+    return;
+  }
+
+  this->disable_loop();
+  if (wait != UINT32_MAX) {
+    this->set_timeout("wake", wait, [this]() { this->enable_loop(); });
+  }
+}
+
+/****************************
+ *Scrolls the stream. This is called from loop(). Each step takes the first character off the stream, which makes
+ * room for new text. The stream keeps scrolling until it is empty, so the last text scrolls off the displays.
+ ****************************/
+void HT16k33CharComponent::update_stream_() {
+  uint32_t now = App.get_loop_component_start_time();
+  uint32_t steps;
+
+  if (this->stream_.empty() || ((now - this->last_scroll_) < this->scroll_speed_)) {
+    return;
+  }
+
+  steps = 1;
+  if (!this->scroll_catch_up_) {
+    steps = std::min<uint32_t>((now - this->last_scroll_) / this->scroll_speed_, this->stream_.size());
+  }
+  this->advance_scroll_time_(now, this->scroll_speed_, steps);
+  this->stream_.pop_front(steps);
+  this->stats_.scroll_steps += steps;
+
+  this->rendered_ = false;
+  this->update_display();
+}
+
+/****************************
+ *Adds text to the back of the stream. The text is compiled into glyphs right away, so scrolling does not have to
+ * decode it. If the stream was empty, blank characters are added first, so that the text scrolls in from the right.
+ *
+ *  text: the text to add.
+ *
+ * Returns: false if characters were dropped because the stream was full.
+ ****************************/
+bool HT16k33CharComponent::stream_push(const char *text) {
+  uint32_t dropped = this->stream_.dropped();
+  size_t width = this->num_chars_per_display_ * this->displays_.size();
+
+  if (this->stream_length_ == 0) {
+    return false;
+  }
+
+  if (this->stream_.empty()) {
+    // Start scrolling from now, not from when the stream ran empty.
+    for (size_t i = 0; (i < width) && (i + 1 < this->stream_.capacity()); i++) {
+      this->stream_.push_back(HT16k33Glyph{0, 0});
+    }
+    this->last_scroll_ = App.get_loop_component_start_time();
+  }
+
+  this->compile_text_(text, strlen(text), this->stream_);
+  this->stats_.stream_dropped += this->stream_.dropped() - dropped;
+
+  this->rendered_ = false;
+  this->enable_loop();
+  return this->stream_.dropped() == dropped;
+}
+
+/****************************
+ *Removes everything from the stream, and blanks the displays.
+ ****************************/
+void HT16k33CharComponent::stream_clear() {
+  this->stream_.clear();
+  this->rendered_ = false;
+  this->update_display();
+}
+
+/****************************
+ *Runs the scrolling state machine. This is called from loop(). When it is time to scroll, the next frame is rendered
+ * and queued for the displays.
+ ****************************/
+void HT16k33CharComponent::update_scroll_() {
   uint32_t now;
-  uint8_t current_buffer_location;
+  uint32_t steps;
+  uint16_t current_buffer_location;
+
+  // The message may have been printed outside of update().
+  this->restart_scroll_();
+
+  if (this->stream_length_ != 0) {
+    this->update_stream_();
+    return;
+  }
 
   if ((this->scroll_state_ == HT16K33_SCROLL_STATE_STATIC) || (this->scroll_state_ == HT16K33_SCROLL_STATE_STOPPED)) {
     // Check this first. If the display is static, we don't need to do anything in this function.
     return;
   }
 
-  now = App.get_loop_component_start_time();
-
-  if (this->last_scroll_ > now) {
-    // This will happen when the millis() function overflows. (approx every 50 days)
-    //  I don't know if App.get_loop_component_start_time() handles this, but if it doesnt,
-    //  this check should keep the code from misbehaving in this instance.
-    this->last_scroll_ = now;
+  if (this->transition_running_()) {
+    // Hold the scroll position while the transition shows the message. run_transition_() starts the scroll timing
+    // again when it ends, so the message goes on from where the transition left it.
     return;
   }
 
+  // last_scroll_ is the time the last step was due, not the time it ran, so loop latency does not add up over the
+  // steps. Times are only compared as unsigned differences, which keeps working when millis() overflows (approx
+  // every 50 days).
+  now = App.get_loop_component_start_time();
+
   switch (this->scroll_state_) {
     case HT16K33_SCROLL_STATE_START:
     case HT16K33_SCROLL_STATE_FIRST_START:
       if ((now - this->last_scroll_) >= this->scroll_delay_) {
         // Start scrolling
-        this->last_scroll_ = now;
-        this->fist_char_location_ += this->char_len_(this->message_buffer_[this->fist_char_location_]);
+        this->advance_scroll_time_(now, this->scroll_delay_, 1);
+        this->fist_char_location_++;
+        this->stats_.scroll_steps++;
         current_buffer_location = this->update_display();
 
         // This handles if there is only a single scroll, it skips directly to STATE_END.
-        if (!(this->continuous_) && ((current_buffer_location + 1) > this->message_buffer_.length())) {
+        if (!(this->continuous_) && (current_buffer_location >= this->glyphs_.size())) {
           this->scroll_state_ = HT16K33_SCROLL_STATE_END;
         } else {
           this->scroll_state_ = HT16K33_SCROLL_STATE_SCROLLING;
@@ -134,16 +542,31 @@ void HT16k33CharComponent::loop() {
 
     case HT16K33_SCROLL_STATE_SCROLLING:
       if ((now - this->last_scroll_) >= this->scroll_speed_) {
-        // Scroll to the next character.
-        this->last_scroll_ = now;
-        this->fist_char_location_ += this->char_len_(this->message_buffer_[this->fist_char_location_]);
-        if (this->fist_char_location_ > this->message_buffer_.length()) {
-          // This only happens in continuous mode.
-          this->fist_char_location_ = 0;
+        // After a stall, either show every step that was missed, one per loop, or skip straight to the step that is
+        // due now.
+        steps = 1;
+        if (!this->scroll_catch_up_) {
+          steps = (now - this->last_scroll_) / this->scroll_speed_;
+          if (!this->continuous_ && (this->fist_char_location_ + steps > this->glyphs_.size())) {
+            // Don't skip past the end of the message.
+            steps = std::max<uint32_t>(this->glyphs_.size() - std::min<uint32_t>(this->fist_char_location_,
+                                                                                  this->glyphs_.size()),
+                                       1);
+          }
+        }
+        this->advance_scroll_time_(now, this->scroll_speed_, steps);
+
+        // Scroll to the next character. In continuous mode, update_display() wraps this back to the start of the
+        // message.
+        if (this->continuous_ && !this->glyphs_.empty()) {
+          this->fist_char_location_ = (this->fist_char_location_ + steps) % this->glyphs_.size();
+        } else {
+          this->fist_char_location_ += steps;
         }
+        this->stats_.scroll_steps += steps;
         current_buffer_location = this->update_display();
 
-        if (!(this->continuous_) && ((current_buffer_location + 1) > this->message_buffer_.length())) {
+        if (!(this->continuous_) && (current_buffer_location >= this->glyphs_.size())) {
           // We have reached the end of the stuff to display. Go to the end delay.
           // The display does not need to be updated here.
           this->scroll_state_ = HT16K33_SCROLL_STATE_END;
@@ -154,7 +577,7 @@ void HT16k33CharComponent::loop() {
     case HT16K33_SCROLL_STATE_END:
       if ((now - this->last_scroll_) >= this->scroll_dwell_) {
         // Go back to the begining
-        this->last_scroll_ = now;
+        this->advance_scroll_time_(now, this->scroll_dwell_, 1);
         this->scroll_state_ = HT16K33_SCROLL_STATE_START;
         this->fist_char_location_ = 0;
         this->update_display();
@@ -163,12 +586,37 @@ void HT16k33CharComponent::loop() {
   }
 }
 
+/****************************
+ *Moves last_scroll_ on to the time the current scroll step was due, and records how late the step is.
+ *
+ *  now: the current time.
+ *
+ *  period: the time between the last step and this one.
+ *
+ *  steps: the number of periods to move on by.
+ ****************************/
+void HT16k33CharComponent::advance_scroll_time_(uint32_t now, uint32_t period, uint32_t steps) {
+  uint32_t jitter;
+
+  this->last_scroll_ += period * steps;
+  jitter = now - this->last_scroll_;
+  this->stats_.scroll_jitter_ms += jitter;
+  if (jitter > this->stats_.max_scroll_jitter_ms) {
+    this->stats_.max_scroll_jitter_ms = jitter;
+  }
+}
+
 void HT16k33CharComponent::dump_config() {
   uint8_t i;
 
   ESP_LOGCONFIG(TAG, "HT16K33 Char:");
   ESP_LOGCONFIG(TAG, "  Max Buffer Length: %d", this->char_buffer_max_size_);
   ESP_LOGCONFIG(TAG, "  Brightness: %d", this->brightness_);
+  if (this->max_bytes_per_loop_ != 0) {
+    ESP_LOGCONFIG(TAG, "  Max Bytes Per Loop: %d per bus", this->max_bytes_per_loop_);
+  } else {
+    ESP_LOGCONFIG(TAG, "  Max Bytes Per Loop: Unlimited");
+  }
 
   // Scrolling stuff
   if (this->scroll_) {
@@ -181,19 +629,92 @@ void HT16k33CharComponent::dump_config() {
     ESP_LOGCONFIG(TAG, "    Scroll Speed:       %0.2f sec", this->scroll_speed_ / 1000.);
     ESP_LOGCONFIG(TAG, "    Scroll Start Delay: %0.2f sec", this->scroll_delay_ / 1000.);
     ESP_LOGCONFIG(TAG, "    Scroll End Delay    %0.2f sec", this->scroll_dwell_ / 1000.);
+    ESP_LOGCONFIG(TAG, "    Catch Up:           %s", YESNO(this->scroll_catch_up_));
   } else {
     ESP_LOGCONFIG(TAG, "  Scrolling: Disabled");
   }
 
+  if (this->transition_ != HT16K33_TRANSITION_NONE) {
+    ESP_LOGCONFIG(TAG, "  Transition: %d, %" PRIu32 " ms", this->transition_, this->transition_duration_);
+  }
+
+  if (this->stream_length_ != 0) {
+    ESP_LOGCONFIG(TAG, "  Stream: %d characters, drop %s", this->stream_length_,
+                  (this->stream_drop_policy_ == HT16K33_STREAM_DROP_OLDEST) ? "oldest" : "newest");
+    ESP_LOGCONFIG(TAG, "    Scroll Speed: %0.2f sec", this->scroll_speed_ / 1000.);
+  }
+
+#ifdef USE_TIME
+  if (this->clock_ != nullptr) {
+    ESP_LOGCONFIG(TAG, "  Clock: \"%s\", every %" PRIu32 " ms", this->clock_format_.c_str(), this->clock_period_);
+    ESP_LOGCONFIG(TAG, "    Leading Zero: %s", YESNO(this->clock_leading_zero_));
+    ESP_LOGCONFIG(TAG, "    Blink Colon:  %s", YESNO(this->clock_blink_colon_));
+  }
+#endif
+
+  if (!this->playlist_.empty()) {
+    ESP_LOGCONFIG(TAG, "  Playlist: %d entries", (int) this->playlist_.size());
+    for (auto &entry : this->playlist_) {
+      ESP_LOGCONFIG(TAG, "    %s, dwell %" PRIu32 " ms, scroll %s, refresh %d",
+                    entry.writer.has_value() ? "Lambda" : entry.text.c_str(), entry.dwell, YESNO(entry.scroll),
+                    entry.refresh);
+    }
+  }
+
   // Display device addresses.
   ESP_LOGCONFIG(TAG, "  Number of displays: %d", this->displays_.size());
 
+#ifdef USE_SENSOR
+  LOG_SENSOR("  ", "Frames", this->frames_sensor_);
+  LOG_SENSOR("  ", "Bytes Written", this->bytes_written_sensor_);
+  LOG_SENSOR("  ", "Transactions", this->transactions_sensor_);
+  LOG_SENSOR("  ", "Write Errors", this->write_errors_sensor_);
+  LOG_SENSOR("  ", "Update Time", this->update_time_sensor_);
+  LOG_SENSOR("  ", "Max Update Time", this->max_update_time_sensor_);
+  LOG_SENSOR("  ", "Writer Time", this->writer_time_sensor_);
+  LOG_SENSOR("  ", "Max Writer Time", this->max_writer_time_sensor_);
+  LOG_SENSOR("  ", "Scroll Rate", this->scroll_rate_sensor_);
+  LOG_SENSOR("  ", "Scroll Jitter", this->scroll_jitter_sensor_);
+  LOG_SENSOR("  ", "Skip Ratio", this->skip_ratio_sensor_);
+  LOG_SENSOR("  ", "Stream Dropped", this->stream_dropped_sensor_);
+  if (this->auto_brightness_sensor_ != nullptr) {
+    LOG_SENSOR("  ", "Auto Brightness", this->auto_brightness_sensor_);
+    for (auto &point : this->auto_brightness_curve_) {
+      ESP_LOGCONFIG(TAG, "    %.2f -> %.2f", point.value, point.brightness);
+    }
+    ESP_LOGCONFIG(TAG, "    Hysteresis: %.2f steps", this->auto_brightness_hysteresis_);
+    ESP_LOGCONFIG(TAG, "    Step Interval: %" PRIu32 " ms", this->auto_brightness_step_interval_);
+  }
+#endif
+
+  if (this->keyscan_) {
+    ESP_LOGCONFIG(TAG, "  Keyscan: Enabled");
+    LOG_PIN("    Interrupt Pin: ", this->interrupt_pin_);
+    ESP_LOGCONFIG(TAG, "    Scan Interval: %" PRIu32 " ms", this->key_scan_interval_);
+    ESP_LOGCONFIG(TAG, "    Debounce: %d scans", this->key_debounce_);
+#ifdef USE_BINARY_SENSOR
+    for (auto *key : this->keys_) {
+      LOG_BINARY_SENSOR("    ", "Key", key);
+    }
+#endif
+  } else {
+    ESP_LOGCONFIG(TAG, "  Keyscan: Disabled");
+  }
+
   ESP_LOGCONFIG(TAG, "  I2C Addresses:");
   i = 0;
-  for (auto *display : this->displays_) {
-    ESP_LOGCONFIG(TAG, "    Device[%d]: 0x%02X", i, display->get_i2c_address());
+  for (auto &display : this->displays_) {
+    if (display.channel != HT16K33_NO_CHANNEL) {
+      ESP_LOGCONFIG(TAG, "    Device[%d]: 0x%02X, bus %d, multiplexer channel %d", i, display.device->get_i2c_address(),
+                    display.bus, display.channel);
+    } else {
+      ESP_LOGCONFIG(TAG, "    Device[%d]: 0x%02X, bus %d", i, display.device->get_i2c_address(), display.bus);
+    }
     i++;
   }
+  if (this->multiplexer_address_ != 0) {
+    ESP_LOGCONFIG(TAG, "  Multiplexer Address: 0x%02X", this->multiplexer_address_);
+  }
 
   if (this->is_failed()) {
     // Nothing in this code actually sets the device to failed, so this should never trigger.
@@ -209,317 +730,1255 @@ void HT16k33CharComponent::dump_config() {
  * turning it off, but it will have the same effect.
  ****************************/
 void HT16k33CharComponent::blank() {
-  for (auto *display : this->displays_) {
+  this->rendered_ = false;
+  for (auto &display : this->displays_) {
+    this->clear_buffer_();
     this->buffer_[0] = HT16K33_DISPLAY_DATA_ADDRESS;
+    this->queue_frame_(display);
+  }
+  this->enable_loop();
+}
+
+/****************************
+ *Updates the displays based on the current message and first_char_location_. If the message changed since the last
+ * update, it is compiled into glyphs_ first.
+ *
+ *  -Returns the glyph position of the *next* character after the last one displayed.
+ *   This can be used to determine scrolling state.
+ ****************************/
+uint16_t HT16k33CharComponent::update_display() {
+  uint32_t start_time = micros();
+  uint32_t update_time;
+  uint16_t glyph_position;
+  bool new_message = false;
+
+  if (this->message_changed_) {
+    // The lambda usually prints the same message again. Only recompile, and start a transition, if it is different.
+    this->message_changed_ = false;
+    if (this->message_buffer_ != this->compiled_message_) {
+      this->compile_message_();
+      new_message = true;
+    }
+  }
+
+  if (this->continuous_ && !this->glyphs_.empty()) {
+    // Wrap the first character back to the start of the message.
+    this->fist_char_location_ = this->fist_char_location_ % this->glyphs_.size();
+  }
+
+  if (!new_message && this->rendered_ && (this->fist_char_location_ == this->rendered_location_) &&
+      !this->transition_running_() && this->displays_ram_valid_()) {
+    // The displays already show this. This is the common case for a clock between minute changes, or a sensor value
+    // that did not move.
+    this->stats_.skipped_frames++;
+    return this->rendered_end_;
+  }
+
+  glyph_position = this->fist_char_location_;
+  if (this->transition_running_() && !new_message) {
+    // Let the transition finish. It ends on the frames of the current message.
+    for (size_t i = 0; i < this->displays_.size(); i++) {
+      glyph_position = this->render_frame_(glyph_position);
+    }
+  } else {
+    for (auto &display : this->displays_) {
+      glyph_position = this->send_to_display_common_(display, glyph_position);
+    }
+    if (new_message && (this->transition_ != HT16K33_TRANSITION_NONE)) {
+      this->start_transition_();
+    }
+  }
+
+  // The frames are sent from loop().
+  this->enable_loop();
+
+  this->rendered_ = true;
+  this->rendered_location_ = this->fist_char_location_;
+  this->rendered_end_ = glyph_position;
+
+  update_time = micros() - start_time;
+  this->stats_.frames++;
+  this->stats_.update_time_us += update_time;
+  if (update_time > this->stats_.max_update_time_us) {
+    this->stats_.max_update_time_us = update_time;
+  }
+
+  return glyph_position;
+}
+
+/***********************************
+ *Write data to a display. All writes to the displays go through this function so that they are counted in stats_.
+ *
+ *  display: the display to write to.
+ *
+ *  data: the bytes to write. The first byte is the command or display data address.
+ *
+ *  len: the number of bytes to write.
+ *
+ * Returns: the error code from the I2C write.
+ ************************************/
+i2c::ErrorCode HT16k33CharComponent::write_display_(HT16k33Display &display, const uint8_t *data, size_t len) {
+  i2c::ErrorCode err;
+
+  err = this->select_channel_(display);
+  if (err != i2c::ERROR_OK) {
+    return err;
+  }
+
+  this->stats_.transactions++;
+  this->stats_.bytes_written += len;
+  err = display.device->write(data, len);
+  if (err != i2c::ERROR_OK) {
+    this->stats_.write_errors++;
+  }
+  return err;
+}
+
+/***********************************
+ *Selects the multiplexer channel of a display. A display that is not behind the multiplexer is accessed with whatever
+ * channel is selected. display.py makes sure that no chip on a channel has its address.
+ *
+ *  display: the display that is about to be accessed.
+ *
+ * Returns: the error code from the I2C write to the multiplexer.
+ ************************************/
+i2c::ErrorCode HT16k33CharComponent::select_channel_(const HT16k33Display &display) {
+  if (!this->behind_multiplexer_(display)) {
+    return i2c::ERROR_OK;
+  }
+  return this->set_mux_channels_(1 << display.channel);
+}
+
+/***********************************
+ *Turns off all multiplexer channels. This is called when the displays are done with the bus, so that the chips behind
+ * the multiplexer do not get in the way of other devices on the bus that use the same addresses.
+ ************************************/
+void HT16k33CharComponent::release_channel_() {
+  if (this->multiplexer_address_ != 0) {
+    this->set_mux_channels_(0);
+  }
+}
+
+/***********************************
+ *Writes the channel mask to the multiplexer, unless the same channels are selected already.
+ *
+ *  channels: the channels to select, as a bit mask.
+ *
+ * Returns: the error code from the I2C write to the multiplexer.
+ ************************************/
+i2c::ErrorCode HT16k33CharComponent::set_mux_channels_(uint8_t channels) {
+  i2c::ErrorCode err;
+
+  if (this->mux_channels_valid_ && (channels == this->mux_channels_)) {
+    return i2c::ERROR_OK;
+  }
+
+  this->stats_.transactions++;
+  this->stats_.bytes_written++;
+  err = this->bus_->write(this->multiplexer_address_, &channels, 1);
+  if (err != i2c::ERROR_OK) {
+    this->stats_.write_errors++;
+  }
+  this->mux_channels_ = channels;
+  this->mux_channels_valid_ = (err == i2c::ERROR_OK);
+  return err;
+}
+
+/***********************************
+ *Logs the cost of the display updates since the last time this was called. This is only logged at the verbose log
+ * level.
+ ************************************/
+void HT16k33CharComponent::log_stats_() {
+  uint32_t frames = this->stats_.frames - this->last_logged_stats_.frames;
+
+  if (frames == 0) {
+    return;
+  }
+
+  ESP_LOGV(TAG,
+           "%" PRIu32 " frames: %.1f bytes/frame, %.1f writes/frame, %" PRIu32 " us/frame (max %" PRIu32
+           " us), max loop %" PRIu32 " us",
+           frames, (float) (this->stats_.bytes_written - this->last_logged_stats_.bytes_written) / frames,
+           (float) (this->stats_.transactions - this->last_logged_stats_.transactions) / frames,
+           (this->stats_.update_time_us - this->last_logged_stats_.update_time_us) / frames,
+           this->stats_.max_update_time_us, this->stats_.max_loop_time_us);
+  this->last_logged_stats_ = this->stats_;
+}
+
+/***********************************
+ *Publishes the counters in stats_ to the sensors that are configured. The totals are published as they are. The
+ * average times and the scroll rate are for the time since the last call. The maximum times are since boot.
+ ************************************/
+void HT16k33CharComponent::publish_stats_() {
+#ifdef USE_SENSOR
+  const HT16k33Stats &last = this->last_published_stats_;
+  uint32_t now = millis();
+  uint32_t frames = this->stats_.frames - last.frames;
+  uint32_t writer_calls = this->stats_.writer_calls - last.writer_calls;
+  uint32_t scroll_steps = this->stats_.scroll_steps - last.scroll_steps;
+  uint32_t skipped_frames = this->stats_.skipped_frames - last.skipped_frames;
+
+  if (this->frames_sensor_ != nullptr) {
+    this->frames_sensor_->publish_state(this->stats_.frames);
+  }
+  if (this->bytes_written_sensor_ != nullptr) {
+    this->bytes_written_sensor_->publish_state(this->stats_.bytes_written);
+  }
+  if (this->transactions_sensor_ != nullptr) {
+    this->transactions_sensor_->publish_state(this->stats_.transactions);
+  }
+  if (this->write_errors_sensor_ != nullptr) {
+    this->write_errors_sensor_->publish_state(this->stats_.write_errors);
+  }
+  if ((this->update_time_sensor_ != nullptr) && (frames != 0)) {
+    this->update_time_sensor_->publish_state((float) (this->stats_.update_time_us - last.update_time_us) / frames);
+  }
+  if (this->max_update_time_sensor_ != nullptr) {
+    this->max_update_time_sensor_->publish_state(this->stats_.max_update_time_us);
+  }
+  if ((this->writer_time_sensor_ != nullptr) && (writer_calls != 0)) {
+    this->writer_time_sensor_->publish_state((float) (this->stats_.writer_time_us - last.writer_time_us) /
+                                             writer_calls);
+  }
+  if (this->max_writer_time_sensor_ != nullptr) {
+    this->max_writer_time_sensor_->publish_state(this->stats_.max_writer_time_us);
+  }
+  if ((this->scroll_rate_sensor_ != nullptr) && (now != this->last_published_time_)) {
+    this->scroll_rate_sensor_->publish_state(scroll_steps * 1000.0f / (now - this->last_published_time_));
+  }
+  if ((this->scroll_jitter_sensor_ != nullptr) && (scroll_steps != 0)) {
+    this->scroll_jitter_sensor_->publish_state((float) (this->stats_.scroll_jitter_ms - last.scroll_jitter_ms) /
+                                               scroll_steps);
+  }
+  if ((this->skip_ratio_sensor_ != nullptr) && (frames + skipped_frames != 0)) {
+    this->skip_ratio_sensor_->publish_state(skipped_frames * 100.0f / (frames + skipped_frames));
+  }
+  if (this->stream_dropped_sensor_ != nullptr) {
+    this->stream_dropped_sensor_->publish_state(this->stats_.stream_dropped);
+  }
+
+  this->last_published_stats_ = this->stats_;
+  this->last_published_time_ = now;
+#endif
+}
+
+/***********************************
+ *Sets the brightness of the display
+ *
+ *  brightness_to_set: The brightness value to set. Valid values are 0-16. Setting brightness to 0
+ *  turns off the display. Setting it to 16 is full brightness. Setting an invalid brightness value
+ *  will result in the device being set to full brightness.
+ ************************************/
+void HT16k33CharComponent::brightness(uint8_t brightness_to_set) {
+  if (brightness_to_set == 0) {
+    this->display_off(true);
+  } else {
+    // Valid brightness values are 0x00 - 0x0F
+    if (brightness_to_set >= 16) {
+      this->dimming_ = 0x0F;
+    } else {
+      this->dimming_ = brightness_to_set - 1;
+    }
+    this->registers_changed_ = true;
+    this->enable_loop();
+  }
+}
+
+/***********************************
+ *Sets the blink function on the HT16k33. This blinking occurs independent of the CPU.
+ *
+ *  blink_state: The desired blink state. Valid values are:
+ *    *0: No Blinking
+ *    *1: Blink rate 2hZ (twice per second)
+ *    *2: Blink rate 1hz (once per second)
+ *    *3: Blink rate .5hZ (once per 2 seconds)
+ *  An invalid blink rate will turn off blinking.
+ ************************************/
+void HT16k33CharComponent::set_blink(uint8_t blink_state) {
+  if (blink_state > 0x03) {
+    // Valid values for blink are 0-3 anything else turns off blinking.
+    this->blink_ = 0;
+  } else {
+    this->blink_ = blink_state;
+  }
+  this->registers_changed_ = true;
+  this->enable_loop();
+}
+
+/***********************************
+ *Turns the displays on or off.
+ *
+ *  turn_off: Boolean. Set to true to turn off the device.
+ *
+ *The blink state is kept, so turning the displays back on restores it.
+ ************************************/
+void HT16k33CharComponent::display_off(bool turn_off) {
+  this->display_on_ = !turn_off;
+  this->registers_changed_ = true;
+  this->enable_loop();
+}
+
+/***********************************
+ *Puts the display into standby mode. This is probably a lower power state than just
+ *turning it off, but I have not tested that.
+ *
+ *  standby: Boolean. Set to true to put the device in standby mode. False to turn it back on.
+ ************************************/
+void HT16k33CharComponent::display_standby(bool standby) {
+  this->standby_ = standby;
+  this->registers_changed_ = true;
+  this->enable_loop();
+}
+
+/***********************************
+ *Writes the requested state of the control registers to the chips. Only the registers whose value changed are
+ * written. This is called once per loop(), so several calls to brightness(), set_blink(), display_off() or
+ * display_standby() in one lambda cost at most one write per register. The writes that do not fit in the byte budget
+ * are sent by the next loop().
+ ************************************/
+void HT16k33CharComponent::commit_registers_() {
+  uint8_t system_setup;
+  uint8_t display_setup;
+  uint8_t dimming;
+  uint8_t row_int;
+  uint8_t blink;
+
+  if (!this->registers_changed_) {
+    return;
+  }
+  this->registers_changed_ = false;
+
+  system_setup = HT16K33_SYSTEM_SETUP | (this->standby_ ? HT16K33_MODE_STANDBY : HT16K33_MODE_NORMAL);
+  blink = (this->blink_override_ != HT16K33_NO_OVERRIDE) ? this->blink_override_ : this->blink_;
+  display_setup =
+      HT16K33_DISPLAY_SETUP | (blink << 1) | (this->display_on_ ? HT16K33_DISPLAY_ON : HT16K33_DISPLAY_OFF);
+  dimming = HT16K33_DIMMING_SET |
+            ((this->dimming_override_ != HT16K33_NO_OVERRIDE) ? this->dimming_override_ : this->dimming_);
+
+  for (uint8_t index : this->bus_order_) {
+    HT16k33Display &display = this->displays_[index];
+    // The ROW15/INT pin is the INT output if the INT pin of a chip that is scanned for keys is connected.
+    row_int = HT16K33_ROW_INT_SET;
+    if (display.keyscan && (this->interrupt_pin_ != nullptr)) {
+      row_int |= HT16K33_ROW_INT_INT_OUTPUT;
+    }
+
+    // The oscillator has to be running before the display is turned on, so the system setup register goes first.
+    if (!this->commit_register_(display, &display.system_setup, system_setup) ||
+        !this->commit_register_(display, &display.dimming, dimming) ||
+        !this->commit_register_(display, &display.display_setup, display_setup) ||
+        !this->commit_register_(display, &display.row_int, row_int)) {
+      // Out of budget. The registers that were written are in the shadows, so the next loop() goes on from here.
+      this->registers_changed_ = true;
+      return;
+    }
+  }
+}
+
+/***********************************
+ *Writes a control register of a chip if the new value is different from the last value written.
+ *
+ *  display: the chip to write to.
+ *
+ *  shadow: the copy of the last value written to the register. This is updated if the write succeeds.
+ *
+ *  value: the command byte to write. This includes the register address.
+ *
+ * Returns: false if the write did not fit in the byte budget.
+ ************************************/
+bool HT16k33CharComponent::commit_register_(HT16k33Display &display, uint8_t *shadow, uint8_t value) {
+  if (*shadow == value) {
+    return true;
+  }
+  if (!this->charge_(display, 1)) {
+    return false;
+  }
+  if (this->write_display_(display, &value, 1) == i2c::ERROR_OK) {
+    *shadow = value;
+  } else {
+    // We don't know what the register holds now.
+    *shadow = 0;
+  }
+  return true;
+}
+
+/***********************************
+ *Look up the character code for a unicode code point in the font table. ASCII characters are read directly from
+ * the table. Other characters are found with a binary search of the sorted non-ASCII part of the table.
+ *
+ *  codepoint: The unicode code point of the character to find.
+ *
+ *  *char_code: The address to store the character code at if the character is found.
+ *
+ * Returns: true if the character is in the font.
+ ************************************/
+bool HT16k33CharComponent::find_char_code_(uint32_t codepoint, uint16_t *char_code) {
+  uint16_t low;
+  uint16_t high;
+  uint16_t middle;
+  uint32_t entry_codepoint;
+  const uint16_t *entry;
+
+  if (this->font_ == nullptr) {
+    return false;
+  }
+
+  if (codepoint < HT16K33_FONT_ASCII_SIZE) {
+    if ((progmem_read_uint16(&this->font_[HT16K33_FONT_ASCII_BITMAP + (codepoint >> 4)]) &
+         (1 << (codepoint & 0x0F))) == 0) {
+      // Not in the font.
+      return false;
+    }
+    *char_code = progmem_read_uint16(&this->font_[codepoint]);
+    return true;
+  }
+
+  low = 0;
+  high = progmem_read_uint16(&this->font_[HT16K33_FONT_EXTENDED_COUNT]);
+  while (low < high) {
+    middle = low + (high - low) / 2;
+    entry = &this->font_[HT16K33_FONT_EXTENDED_START + middle * HT16K33_FONT_EXTENDED_ENTRY_SIZE];
+    entry_codepoint = ((uint32_t) progmem_read_uint16(&entry[0]) << 16) | progmem_read_uint16(&entry[1]);
+
+    if (entry_codepoint == codepoint) {
+      *char_code = progmem_read_uint16(&entry[2]);
+      return true;
+    } else if (entry_codepoint < codepoint) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return false;
+}
+
+/***********************************
+ *Decodes the UTF-8 encoded character at the start of a string.
+ *  NOTE: std::mblen() is supposed to do this too, but it doesnt seem to work here. It always returns 1.
+ *
+ *  str: The first byte of the character.
+ *
+ *  length: The number of bytes left in the string, at least 1.
+ *
+ *  *codepoint: The address to store the unicode code point of the character. If the bytes at position are not a
+ *              valid UTF-8 character, this is set to HT16K33_INVALID_CODEPOINT.
+ *
+ * Returns: The number of bytes used by the character. This is at least 1, so that invalid bytes are skipped over
+ *          one at a time.
+ ************************************/
+uint8_t HT16k33CharComponent::decode_char_(const char *str, size_t length, uint32_t *codepoint) {
+  uint8_t first_byte = std::char_traits<char>::to_int_type(str[0]);
+  uint8_t next_byte;
+  uint8_t char_length;
+
+  if (first_byte <= 0x7F) {
+    // Single byte character
+    *codepoint = first_byte;
+    return 1;
+  } else if ((first_byte & 0xE0) == 0xC0) {
+    // Two byte character
+    *codepoint = first_byte & 0x1F;
+    char_length = 2;
+  } else if ((first_byte & 0xF0) == 0xE0) {
+    // Three byte character
+    *codepoint = first_byte & 0x0F;
+    char_length = 3;
+  } else if ((first_byte & 0xF8) == 0xF0) {
+    // Four byte character
+    *codepoint = first_byte & 0x07;
+    char_length = 4;
+  } else {
+    // Not a valid first byte. This is either a continuation byte without a first byte or an invalid byte.
+    *codepoint = HT16K33_INVALID_CODEPOINT;
+    return 1;
+  }
+
+  if (char_length > length) {
+    // The character is cut off by the end of the message.
+    *codepoint = HT16K33_INVALID_CODEPOINT;
+    return 1;
+  }
+
+  // The remaining bytes hold 6 bits of the code point each, and must all be continuation bytes (0b10xxxxxx).
+  for (uint8_t i = 1; i < char_length; i++) {
+    next_byte = std::char_traits<char>::to_int_type(str[i]);
+    if ((next_byte & 0xC0) != 0x80) {
+      *codepoint = HT16K33_INVALID_CODEPOINT;
+      return 1;
+    }
+    *codepoint = (*codepoint << 6) | (next_byte & 0x3F);
+  }
+  return char_length;
+}
+
+/***********************************
+ *Converts a code point to the char looked up by find_special_char_(). All special characters are ASCII, so any
+ * other character is converted to '\0', which is never a special character.
+ ************************************/
+static char special_char_from_codepoint(uint32_t codepoint) {
+  if (codepoint < 0x80) {
+    return (char) codepoint;
+  }
+  return '\0';
+}
+
+/***********************************
+ *Compile the message buffer into glyphs_. This is done once each time the message changes, so that updating the
+ * display for each scroll step does not need to decode the message or look up characters in the font.
+ ************************************/
+void HT16k33CharComponent::compile_message_() {
+  this->glyphs_.clear();
+  this->compiled_message_ = this->message_buffer_;
+  this->compile_text_(this->message_buffer_.data(), this->message_buffer_.length(), this->glyphs_);
+}
+
+/***********************************
+ *Compile a string into glyphs, and add them to the back of a glyph container. The special characters of the device
+ * are looked up in its layout.
+ *
+ * Each character in the message becomes one glyph, except for special characters that light a segment of the digit
+ * next to them, such as decimal points. These are merged into the character code of that digit. Special characters
+ * that are only valid at certain locations on the display, such as colons, are stored as a glyph with special
+ * set. Whether they are shown depends on where they land on the display, so a special character that follows one of
+ * them is stored as a glyph with special set too, and render_frame_() decides. A character that is not in the font
+ * or a special character is stored as a blank glyph. Only one special character is merged between two digits.
+ *
+ *  str: The string to compile.
+ *
+ *  length: The length of the string in bytes.
+ *
+ *  glyphs: The container to add the glyphs to. This is glyphs_ for the message, or the stream.
+ ************************************/
+template<typename T> void HT16k33CharComponent::compile_text_(const char *str, size_t length, T &glyphs) {
+  size_t char_buffer_location;
+  uint32_t codepoint;
+  uint16_t char_code;
+  uint16_t next_char_bits;
+  uint8_t special;
+  bool special_character_found;
+
+  char_buffer_location = 0;
+  next_char_bits = 0;
+  special_character_found = false;
+
+  while (char_buffer_location < length) {
+    // Invalid UTF-8 bytes decode to HT16K33_INVALID_CODEPOINT, which is not in any font. These are displayed as a
+    // blank digit.
+    char_buffer_location +=
+        this->decode_char_(&str[char_buffer_location], length - char_buffer_location, &codepoint);
+
+    if (this->find_char_code_(codepoint, &char_code)) {
+      glyphs.push_back(HT16k33Glyph{(uint16_t) (char_code | next_char_bits), 0});
+      next_char_bits = 0;
+      special_character_found = false;
+      continue;
+    }
+
+    // The character is not in the font. Check if it is a special character.
+    special = this->find_special_char_(special_char_from_codepoint(codepoint));
+    if (!special_character_found && (special < this->layout_.num_special_chars)) {
+      if ((this->layout_.special_types[special] == SPECIAL_CHAR_POSITIONAL) ||
+          (!glyphs.empty() && (glyphs.back().special != 0))) {
+        glyphs.push_back(HT16k33Glyph{0, (uint8_t) (special + 1)});
+        continue;
+      }
+      switch (this->layout_.special_types[special]) {
+        case SPECIAL_CHAR_ATTACH_PREVIOUS:
+          // A special character at the start of the message has no digit to attach to, and is skipped.
+          if (!glyphs.empty()) {
+            glyphs.back().char_code |= this->layout_.special_bits[special];
+          }
+          special_character_found = true;
+          continue;
+        case SPECIAL_CHAR_ATTACH_NEXT:
+          next_char_bits |= this->layout_.special_bits[special];
+          special_character_found = true;
+          continue;
+      }
+    }
+
+    // The character is not in the font or a special character, it is displayed as a blank digit.
+    glyphs.push_back(HT16k33Glyph{next_char_bits, 0});
+    next_char_bits = 0;
+    special_character_found = false;
+  }
+
+  if (next_char_bits != 0) {
+    // A special character at the end of the message that attaches to the next digit. Show it on a blank digit.
+    glyphs.push_back(HT16k33Glyph{next_char_bits, 0});
+  }
+}
+
+/***********************************
+ *Set the layout of the device. HT16k33CharDevice calls this with the layout that it unpacked at compile time. The
+ * layout is also kept in layout_, for compiling messages and for the transitions that draw one digit at a time.
+ *
+ *  layout: The unpacked layout table.
+ ************************************/
+void HT16k33CharComponent::set_layout_(const HT16k33Layout &layout) {
+  const HT16k33Layout &l = this->layout_;
+  uint8_t special;
+
+  this->layout_ = layout;
+  this->num_chars_per_display_ = l.num_digits;
+
+  // The colon between digits 2 and 3 is the one that the clock blinks.
+  special = this->find_special_char_(':');
+  if ((special < l.num_special_chars) && (l.num_digits >= 2) && (l.special_index[special][2] != 0)) {
+    this->colon_index_ = l.special_index[special][2];
+    this->colon_bits_ = l.special_mask[special][2];
+  } else {
+    this->colon_index_ = 0;
+    this->colon_bits_ = 0;
+  }
+}
+
+/***********************************
+ *Find a special character in the layout.
+ *
+ *  special_char: The character to find.
+ *
+ * Returns: The index of the special character in the layout, or num_special_chars if the device has no such
+ *  special character.
+ ************************************/
+uint8_t HT16k33CharComponent::find_special_char_(char special_char) const {
+  uint8_t special;
+
+  for (special = 0; special < this->layout_.num_special_chars; special++) {
+    if (this->layout_.special_chars[special] == special_char) {
+      break;
+    }
+  }
+  return special;
+}
+
+/***********************************
+ *Write the segments of a character code to a digit in buffer_.
+ *
+ *  char_code: The character code to write.
+ *
+ *  digit: The digit of the display to write it to.
+ ************************************/
+void HT16k33CharComponent::write_digit_(uint16_t char_code, uint8_t digit) {
+  const HT16k33Layout &l = this->layout_;
+  uint8_t *buffer = &this->buffer_[l.digit_index[digit]];
+  uint8_t segment;
+
+  char_code &= l.segment_mask;
+  if (l.direct) {
+    buffer[0] |= char_code & 0xFF;
+    buffer[1] |= char_code >> 8;
+    return;
+  }
+
+  while (char_code != 0) {
+    segment = l.segments[__builtin_ctz(char_code)];
+    buffer[segment >> 3] |= 1 << ((segment & 0x07) + l.digit_shift[digit]);
+    char_code &= char_code - 1;
+  }
+}
+
+/***********************************
+ *Decides which chips to scan for keys. A chip is scanned if it has keys registered, or if there is an on_key
+ * automation. If the INT pin is connected, commit_registers_() sets up the ROW15/INT pin of the scanned chips as the
+ * INT output, and a key press wakes loop() through the interrupt of the pin.
+ ************************************/
+void HT16k33CharComponent::setup_keyscan_() {
+#ifdef USE_BINARY_SENSOR
+  for (auto *key : this->keys_) {
+    if (key->get_chip() >= this->displays_.size()) {
+      ESP_LOGW(TAG, "Key %d is on chip %d, but there are only %d chips", key->get_key(), key->get_chip(),
+               (int) this->displays_.size());
+      continue;
+    }
+    this->displays_[key->get_chip()].keyscan = true;
+  }
+#endif
+
+  for (auto &display : this->displays_) {
+    if (this->key_callback_.size() > 0) {
+      display.keyscan = true;
+    }
+    if (!display.keyscan) {
+      continue;
+    }
+    this->keyscan_ = true;
+  }
+
+  if (this->keyscan_ && (this->interrupt_pin_ != nullptr)) {
+    this->interrupt_pin_->setup();
+    // The INT pin is active low, and goes active when a key is pressed.
+    this->interrupt_pin_->attach_interrupt(HT16k33CharComponent::key_isr_, this, gpio::INTERRUPT_FALLING_EDGE);
+  }
+}
+
+/***********************************
+ *The interrupt of the INT pin. It only notes the key press and wakes loop(), which scans the keys.
+ ************************************/
+void IRAM_ATTR HT16k33CharComponent::key_isr_(HT16k33CharComponent *component) {
+  component->key_interrupt_ = true;
+  component->enable_loop_soon_any_context();
+}
+
+/***********************************
+ *Scans the keys of the chips every key_scan_interval_ ms. This is called from loop(). If the byte budget runs out, the
+ * scan goes on from the chip it stopped at in the next loop().
+ *
+ * If the INT pin is connected, the keys are only scanned after it went active, and until no key is pressed or
+ * debouncing any more.
+ ************************************/
+void HT16k33CharComponent::scan_keys_() {
+  uint32_t now;
+  bool interrupted;
+
+  if (!this->keyscan_) {
+    return;
+  }
+
+  if (!this->key_scan_running_) {
+    now = App.get_loop_component_start_time();
+    if ((now - this->last_key_scan_) < this->key_scan_interval_) {
+      return;
+    }
+
+    // The INT pin is active low. It is active while any key is pressed. If it is not connected, every chip has to be
+    // asked.
+    if (this->interrupt_pin_ == nullptr) {
+      this->key_scan_check_chips_ = true;
+    } else {
+      interrupted = this->key_interrupt_;
+      this->key_interrupt_ = false;
+      this->key_scan_check_chips_ = interrupted || !this->interrupt_pin_->digital_read();
+      if (!this->key_scan_check_chips_ && !this->keys_settling_) {
+        return;
+      }
+    }
+    this->last_key_scan_ = now;
+    this->key_scan_running_ = true;
+    this->key_scan_cursor_ = 0;
+    this->keys_settling_ = false;
+  }
+
+  for (; this->key_scan_cursor_ < this->bus_order_.size(); this->key_scan_cursor_++) {
+    uint8_t chip = this->bus_order_[this->key_scan_cursor_];
+    HT16k33Display &display = this->displays_[chip];
+    if (display.keyscan && !this->scan_keys_of_(display, chip, this->key_scan_check_chips_)) {
+      return;
+    }
+    // A key that is held, or a key state that is not debounced yet, needs more scans. The INT pin only announces
+    // presses, not releases.
+    if (display.keyscan && ((display.key_scan_count < this->key_debounce_) ||
+                            std::any_of(std::begin(display.key_scan), std::end(display.key_scan),
+                                        [](uint8_t byte) { return byte != 0; }))) {
+      this->keys_settling_ = true;
+    }
+  }
+  this->key_scan_running_ = false;
+}
+
+/***********************************
+ *Scans the keys of one chip and reports the keys that changed state. To keep the bus quiet, only the one byte INT
+ * flag is read. The six bytes of key data RAM are only read when the flag shows that a key is pressed.
+ *
+ *  display: the chip to scan.
+ *
+ *  chip: the index of the chip in displays_.
+ *
+ *  check_chip: false if it is already known that no keys are pressed, for example because the INT pin is not active.
+ *
+ * Returns: false if a read did not fit in the byte budget. The chip is scanned again by the next loop(). The INT flag
+ *          stays set until the key data is read, so no key press is lost.
+ ************************************/
+bool HT16k33CharComponent::scan_keys_of_(HT16k33Display &display, uint8_t chip, bool check_chip) {
+  uint8_t scan[HT16K33_KEY_DATA_SIZE] = {0};
+  uint8_t flag = 0;
+  uint8_t key;
+  uint8_t byte;
+  uint8_t mask;
+  uint8_t i;
+
+  if (check_chip) {
+    // Each read writes the register address first.
+    if (!this->charge_(display, 1 + 1)) {
+      return false;
+    }
+    if ((this->select_channel_(display) != i2c::ERROR_OK) ||
+        (display.device->read_register(HT16K33_INT_FLAG_ADDRESS, &flag, 1) != i2c::ERROR_OK)) {
+      return true;
+    }
+    if (flag != 0) {
+      if (!this->charge_(display, 1 + HT16K33_KEY_DATA_SIZE)) {
+        return false;
+      }
+      if (display.device->read_register(HT16K33_KEY_DATA_ADDRESS, scan, HT16K33_KEY_DATA_SIZE) != i2c::ERROR_OK) {
+        return true;
+      }
+    }
+    // Only K1-K13 are used. The upper three bits of the second byte of each common are not keys.
+    for (i = 1; i < HT16K33_KEY_DATA_SIZE; i += 2) {
+      scan[i] &= 0x1F;
+    }
+  }
+
+  // Debounce. The keys only change state after the same key state is read key_debounce_ times in a row.
+  if (memcmp(scan, display.key_scan, HT16K33_KEY_DATA_SIZE) != 0) {
+    memcpy(display.key_scan, scan, HT16K33_KEY_DATA_SIZE);
+    display.key_scan_count = 1;
+  } else if (display.key_scan_count < this->key_debounce_) {
+    display.key_scan_count++;
+  }
+
+  if ((display.key_scan_count < this->key_debounce_) ||
+      (memcmp(display.key_scan, display.keys, HT16K33_KEY_DATA_SIZE) == 0)) {
+    return true;
+  }
+
+  for (key = 0; key < HT16K33_NUM_KEYS; key++) {
+    byte = ((key / HT16K33_KEYS_PER_COMMON) * 2) + ((key % HT16K33_KEYS_PER_COMMON) / 8);
+    mask = 1 << ((key % HT16K33_KEYS_PER_COMMON) % 8);
+    if ((display.key_scan[byte] & mask) && !(display.keys[byte] & mask)) {
+      ESP_LOGD(TAG, "Key %d of chip %d pressed", key, chip);
+      this->key_callback_.call(chip, key);
+    }
+  }
+  memcpy(display.keys, display.key_scan, HT16K33_KEY_DATA_SIZE);
+
+#ifdef USE_BINARY_SENSOR
+  for (auto *key_sensor : this->keys_) {
+    if (key_sensor->get_chip() == chip) {
+      key_sensor->publish_state(this->is_key_pressed(chip, key_sensor->get_key()));
+    }
+  }
+#endif
+
+  return true;
+}
+
+/***********************************
+ *Returns the debounced state of a key.
+ *
+ *  chip: the index of the chip in the display chain. 0 is the primary display.
+ *
+ *  key: the key number, see HT16K33_KEYS_PER_COMMON.
+ ************************************/
+bool HT16k33CharComponent::is_key_pressed(uint8_t chip, uint8_t key) const {
+  uint8_t byte;
+
+  if ((chip >= this->displays_.size()) || (key >= HT16K33_NUM_KEYS)) {
+    return false;
+  }
+  byte = ((key / HT16K33_KEYS_PER_COMMON) * 2) + ((key % HT16K33_KEYS_PER_COMMON) / 8);
+  return (this->displays_[chip].keys[byte] & (1 << ((key % HT16K33_KEYS_PER_COMMON) % 8))) != 0;
+}
+
+/***********************************
+ * Write the glyphs to the display send buffer and queue it for the display indicated.
+ *
+ *  display: the display device to send the buffer to.
+ *
+ *  position: The glyph position in the message of the first character to display.
+ *
+ * Returns: the glyph position in the message of the next character. This is the position to send to the next display
+ *          if one is present.
+ ************************************/
+uint16_t HT16k33CharComponent::send_to_display_common_(HT16k33Display &display, uint16_t position) {
+  position = this->render_frame_(position);
+  if (this->colon_bits_ != 0) {
+    display.colon = this->buffer_[this->colon_index_] & this->colon_bits_;
+    if (!this->colon_visible_) {
+      this->buffer_[this->colon_index_] &= ~this->colon_bits_;
+    }
+  }
+  this->queue_frame_(display);
+  return position;
+}
+
+/***********************************
+ *Computes the keyframes of a transition from what is on the displays now to the frames that update_display() just
+ * queued. The queued frames are held back, and run_transition_() sends the keyframes as they become due.
+ ************************************/
+void HT16k33CharComponent::start_transition_() {
+  uint32_t duration = this->transition_duration_;
+  uint8_t work[HT16K33_FRAME_SIZE];
+  uint16_t digits;
+  uint16_t step;
+  uint16_t position;
+  uint8_t chip;
+  uint8_t digit;
+  uint8_t i;
+
+  this->keyframes_.clear();
+  this->next_keyframe_ = 0;
+  this->transition_start_ = App.get_loop_component_start_time();
+
+  // Undo what is left of the last transition.
+  this->dimming_override_ = HT16K33_NO_OVERRIDE;
+  this->blink_override_ = HT16K33_NO_OVERRIDE;
+  this->registers_changed_ = true;
+
+  switch (this->transition_) {
+    case HT16K33_TRANSITION_WIPE:
+      // Replace the old message one digit at a time, from the first digit of the first display to the last digit of
+      // the last display.
+      digits = this->num_chars_per_display_ * this->displays_.size();
+      step = 0;
+      chip = 0;
+      for (auto &display : this->displays_) {
+        memcpy(work, display.ram, HT16K33_FRAME_SIZE);
+        for (digit = 0; digit < this->num_chars_per_display_; digit++) {
+          // Lighting every segment of the digit shows which bits of the display RAM belong to it.
+          this->clear_buffer_();
+          this->write_digit_(0xFFFF, digit);
+          for (i = 1; i < HT16K33_FRAME_SIZE; i++) {
+            work[i] = (work[i] & ~this->buffer_[i]) | (display.frame[i] & this->buffer_[i]);
+          }
+          this->add_frame_keyframe_((step * duration) / digits, chip, work);
+          step++;
+        }
+        chip++;
+      }
+      // Special characters that are not part of a digit, such as a colon, are shown at the end.
+      chip = 0;
+      for (auto &display : this->displays_) {
+        this->add_frame_keyframe_(duration, chip, display.frame);
+        chip++;
+      }
+      break;
+
+    case HT16K33_TRANSITION_BUILD:
+      // Draw the new message one segment at a time. display.frame holds the last frame added for each chip, so that
+      // steps that don't change a chip are left out.
+      for (auto &display : this->displays_) {
+        memcpy(display.frame, display.ram, HT16K33_FRAME_SIZE);
+      }
+      for (step = 0; step < 16; step++) {
+        this->segment_mask_ = (2 << step) - 1;
+        position = this->fist_char_location_;
+        chip = 0;
+        for (auto &display : this->displays_) {
+          position = this->render_frame_(position);
+          if (memcmp(&this->buffer_[1], &display.frame[1], HT16K33_FRAME_SIZE - 1) != 0) {
+            memcpy(display.frame, this->buffer_, HT16K33_FRAME_SIZE);
+            this->add_frame_keyframe_((step * duration) / 15, chip, this->buffer_);
+          }
+          chip++;
+        }
+      }
+      this->segment_mask_ = 0xFFFF;
+      break;
+
+    case HT16K33_TRANSITION_FADE:
+      // Fade out, swap the frames at the lowest brightness halfway through, then fade back in. The HT16K33 can't dim
+      // all the way to off, so the lowest brightness is 1/16.
+      for (step = 1; step <= this->dimming_; step++) {
+        this->add_register_keyframe_((step * duration) / (2 * this->dimming_), HT16K33_KEYFRAME_DIMMING,
+                                     this->dimming_ - step);
+      }
+      chip = 0;
+      for (auto &display : this->displays_) {
+        this->add_frame_keyframe_(duration / 2, chip, display.frame);
+        chip++;
+      }
+      for (step = 1; step < this->dimming_; step++) {
+        this->add_register_keyframe_((duration / 2) + (step * duration) / (2 * this->dimming_),
+                                     HT16K33_KEYFRAME_DIMMING, step);
+      }
+      this->add_register_keyframe_(duration, HT16K33_KEYFRAME_DIMMING, HT16K33_NO_OVERRIDE);
+      break;
 
-    // Clear the buffer
-    for (int i = 1; i < 16; i++) {
-      this->buffer_[i] = 0x00;
-    }
-    display->write(this->buffer_, 16);
+    case HT16K33_TRANSITION_FLASH:
+      // Show the new message right away, blinking at 2 Hz until the transition ends.
+      chip = 0;
+      for (auto &display : this->displays_) {
+        this->add_frame_keyframe_(0, chip, display.frame);
+        chip++;
+      }
+      this->add_register_keyframe_(0, HT16K33_KEYFRAME_BLINK, 1);
+      this->add_register_keyframe_(duration, HT16K33_KEYFRAME_BLINK, HT16K33_NO_OVERRIDE);
+      break;
   }
-}
-
-/****************************
- *Updates the displays based on the current char_buffer_ and first_char_location_.
- *
- *  -Returns the buffer location of the *next* character after the last one displayed.
- *   This can be used to determine scrolling state.
- ****************************/
-uint8_t HT16k33CharComponent::update_display() {
-  uint8_t buffer_location = this->fist_char_location_;
 
-  for (auto *display : this->displays_) {
-    buffer_location = this->send_to_display_common_(display, buffer_location);
+  // The frames queued by update_display() are sent by the keyframes.
+  for (auto &display : this->displays_) {
+    display.frame_pending = false;
   }
 
-  return buffer_location;
+  this->run_transition_();
 }
 
 /***********************************
- *Sets the brightness of the display
+ *Adds a keyframe that sends a frame to a chip.
  *
- *  brightness_to_set: The brightness value to set. Valid values are 0-16. Setting brightness to 0
- *  turns off the display. Setting it to 16 is full brightness. Setting an invalid brightness value
- *  will result in the device being set to full brightness.
+ *  time: the time from the start of the transition, in ms.
+ *
+ *  chip: the index of the chip in displays_.
+ *
+ *  frame: the frame to send.
  ************************************/
-void HT16k33CharComponent::brightness(uint8_t brightness_to_set) {
-  uint8_t buffer;
-
-  if (brightness_to_set == 0) {
-    this->display_off(true);
-  } else {
-    // Valid brightness values are 0x00 - 0x0F
-    if (brightness_to_set >= 16) {
-      buffer = HT16K33_DIMMING_SET | 0x0F;
-    } else {
-      buffer = HT16K33_DIMMING_SET | (brightness_to_set - 1);
-    }
-
-    for (auto *display : this->displays_) {
-      display->write(&buffer, 1);
-    }
-  }
+void HT16k33CharComponent::add_frame_keyframe_(uint32_t time, uint8_t chip, const uint8_t *frame) {
+  HT16k33Keyframe keyframe{time, HT16K33_KEYFRAME_FRAME, chip, 0, {}};
+  memcpy(keyframe.frame, frame, HT16K33_FRAME_SIZE);
+  this->keyframes_.push_back(keyframe);
 }
 
 /***********************************
- *Sets the blink function on the HT16k33. This blinking occurs independent of the CPU.
+ *Adds a keyframe that sets the dimming or blink rate of all chips.
  *
- *  blink_state: The desired blink state. Valid values are:
- *    *0: No Blinking
- *    *1: Blink rate 2hZ (twice per second)
- *    *2: Blink rate 1hz (once per second)
- *    *3: Blink rate .5hZ (once per 2 seconds)
- *  An invalid blink rate will turn off blinking.
+ *  time: the time from the start of the transition, in ms.
+ *
+ *  type: HT16K33_KEYFRAME_DIMMING or HT16K33_KEYFRAME_BLINK.
+ *
+ *  value: the dimming (0-15) or blink rate (0-3), or HT16K33_NO_OVERRIDE to go back to the normal setting.
  ************************************/
-void HT16k33CharComponent::set_blink(uint8_t blink_state) {
-  uint8_t buffer;
+void HT16k33CharComponent::add_register_keyframe_(uint32_t time, uint8_t type, uint8_t value) {
+  this->keyframes_.push_back(HT16k33Keyframe{time, type, 0, value, {}});
+}
 
-  if (blink_state > 0x03) {
-    // Valid values for blink are 0-3 anything else turns off blinking.
-    buffer = HT16K33_DISPLAY_SETUP | HT16K33_DISPLAY_ON;
-  } else {
-    buffer = HT16K33_DISPLAY_SETUP | (blink_state << 1) | HT16K33_DISPLAY_ON;
+/***********************************
+ *Applies the keyframes of the transition that are due. This is called from loop(). Frames are queued for the
+ * displays, and register changes are sent by commit_registers_().
+ ************************************/
+void HT16k33CharComponent::run_transition_() {
+  uint32_t elapsed;
+
+  if (!this->transition_running_()) {
+    return;
+  }
+
+  elapsed = App.get_loop_component_start_time() - this->transition_start_;
+  while (this->transition_running_() && (this->keyframes_[this->next_keyframe_].time <= elapsed)) {
+    const HT16k33Keyframe &keyframe = this->keyframes_[this->next_keyframe_];
+    this->next_keyframe_++;
+
+    switch (keyframe.type) {
+      case HT16K33_KEYFRAME_FRAME:
+        // A newer frame replaces a frame that was not sent yet.
+        memcpy(this->displays_[keyframe.chip].frame, keyframe.frame, HT16K33_FRAME_SIZE);
+        this->displays_[keyframe.chip].frame_pending = true;
+        break;
+      case HT16K33_KEYFRAME_DIMMING:
+        this->dimming_override_ = keyframe.value;
+        this->registers_changed_ = true;
+        break;
+      case HT16K33_KEYFRAME_BLINK:
+        this->blink_override_ = keyframe.value;
+        this->registers_changed_ = true;
+        break;
+    }
   }
 
-  for (auto *display : this->displays_) {
-    display->write(&buffer, 1);
+  if (!this->transition_running_()) {
+    // The scroll was held during the transition. The next step is one period after the last keyframe.
+    this->last_scroll_ = this->transition_start_ + this->keyframes_.back().time;
   }
 }
 
 /***********************************
- *Turns the displays on or off.
- *
- *  turn_off: Boolean. Set to true to turn off the device.
+ *Queue the frame in buffer_ for a display. If an older frame for the display has not been completely sent yet, it is
+ * replaced by this one, since only the newest frame needs to be shown. Queued frames are sent by flush_displays_().
  *
- *Note: this function will also clear the bink state.
+ *  display: the display to queue the frame for.
  ************************************/
-void HT16k33CharComponent::display_off(bool turn_off) {
-  uint8_t buffer;
+void HT16k33CharComponent::queue_frame_(HT16k33Display &display) {
+  memcpy(display.frame, this->buffer_, HT16K33_FRAME_SIZE);
+  display.frame_pending = true;
+}
 
-  if (turn_off) {
-    buffer = HT16K33_DISPLAY_SETUP | HT16K33_DISPLAY_OFF;
-  } else {
-    buffer = HT16K33_DISPLAY_SETUP | HT16K33_DISPLAY_ON;
+/***********************************
+ *Turns the colon between digits 2 and 3 on or off without rendering the frames again. Only the byte of the frame that
+ * holds the colon changes, so flush_display_() sends just that byte. loop() sends the frames.
+ *
+ *  visible: true to show the colon of the rendered frames, false to turn it off.
+ ************************************/
+void HT16k33CharComponent::show_colon_(bool visible) {
+  if ((this->colon_bits_ == 0) || (visible == this->colon_visible_)) {
+    return;
   }
-
-  for (auto *display : this->displays_) {
-    display->write(&buffer, 1);
+  this->colon_visible_ = visible;
+
+  for (auto &display : this->displays_) {
+    uint8_t &colon_byte = display.frame[this->colon_index_];
+    uint8_t value = visible ? (colon_byte | display.colon) : (colon_byte & ~this->colon_bits_);
+    if (value != colon_byte) {
+      colon_byte = value;
+      display.frame_pending = true;
+    }
   }
 }
 
 /***********************************
- *Puts the display into standby mode. This is probably a lower power state than just
- *turning it off, but I have not tested that.
- *
- *  standby: Boolean. Set to true to put the device in standby mode. False to turn it back on.
+ *Returns true if the contents of the display RAM of every chip are known. If a write failed, they are not, and the
+ * next frame has to be sent even if the message did not change.
  ************************************/
-void HT16k33CharComponent::display_standby(bool standby) {
-  uint8_t buffer;
-
-  if (standby) {
-    buffer = HT16K33_SYSTEM_SETUP | HT16K33_MODE_STANDBY;
-  } else {
-    buffer = HT16K33_SYSTEM_SETUP | HT16K33_MODE_NORMAL;
+bool HT16k33CharComponent::displays_ram_valid_() const {
+  for (auto &display : this->displays_) {
+    if (!display.ram_valid) {
+      return false;
+    }
   }
+  return true;
+}
 
-  for (auto *display : this->displays_) {
-    display->write(&buffer, 1);
+/***********************************
+ *Sets the byte budget of each bus for this call to loop(). If the multiplexer is used, one byte of the primary bus is
+ * kept back, so that the channels can always be released at the end of loop().
+ ************************************/
+void HT16k33CharComponent::reset_budgets_() {
+  std::fill(this->bus_budgets_.begin(), this->bus_budgets_.end(), this->max_bytes_per_loop_);
+  if ((this->multiplexer_address_ != 0) && !this->bus_budgets_.empty() && (this->bus_budgets_[0] > 0)) {
+    this->bus_budgets_[0]--;
   }
 }
 
 /***********************************
- * Gets a string that represents the next character to display.
- *  Assumes UTF-8 encoding.
+ *Takes the bytes of an access to a display from the budget of its bus. If the multiplexer has to switch to the channel
+ * of the display first, that byte is charged too.
  *
- *  start_position: The start position in the message buffer array.
+ *  display: the display that is about to be accessed.
  *
- *  *next_char: The address of a std::string to store the next character string.
+ *  bytes: the bytes that the access sends and reads, without the address byte of each transaction.
  *
- * Returns the number of bytes it took to get the next character. (this will usually be 1, but not always.)
+ * Returns: true if the access fits in the budget, and was charged. If it does not fit, nothing is charged.
  ************************************/
-uint8_t HT16k33CharComponent::get_next_char_(uint16_t start_position, std::string *next_char) {
-  char first_char = this->message_buffer_[start_position];
-  uint8_t next_char_length = this->char_len_(first_char);
-
-  // Clear contents from the string to hold the next character.
-  next_char->resize(1);
-  next_char->clear();
-
-  // Add all of the chars that represent the character to display.
-  for (uint8_t i = 0; i < next_char_length; i++) {
-    next_char->push_back(this->message_buffer_.at(start_position + i));
+bool HT16k33CharComponent::charge_(const HT16k33Display &display, uint16_t bytes) {
+  if (this->max_bytes_per_loop_ == 0) {
+    return true;
   }
-
-  return next_char_length;
+  if (this->behind_multiplexer_(display) &&
+      (!this->mux_channels_valid_ || ((1 << display.channel) != this->mux_channels_))) {
+    bytes++;
+  }
+  if (this->bus_budgets_[display.bus] < bytes) {
+    return false;
+  }
+  this->bus_budgets_[display.bus] -= bytes;
+  return true;
 }
 
 /***********************************
- *Given a 8-bit char, determines the number of bytes that are needed to represent the character code.
- *  This will by typically be 1 for normal characters, but for multi-byte characters, it may be up to 4.
- *  Assumes UTF-8 encoding.
- *  NOTE: std::mblen() is supposed to do this too, but it doesnt seem to work here. It always returns 1.
- *
- *  char_to_test: An 8-bit char representing the first byte of the character to check.
+ *Send the queued frames to the displays. Each bus has its own queue and its own byte budget, and the buses take turns
+ * one write at a time, so the writes of a frame that is split over several buses are interleaved.
  *
- * Returns: The number of bytes needed to represent the character.
+ * ESPHome I2C writes block until the transfer is done, so the buses still do not transfer at the same time, and a
+ * frame takes the sum of the bus times. Interleaving only lets the transfers overlap with a bus driver that returns
+ * before its transfer is done. What the split does in any case is give each bus its own budget, so that a frame split
+ * over several buses is done in the number of calls to loop() that the busiest bus needs, not in the sum of them.
  ************************************/
-uint8_t HT16k33CharComponent::char_len_(char char_to_test) {
-  uint8_t first_char;
+void HT16k33CharComponent::flush_displays_() {
+  bool wrote;
 
-  first_char = std::char_traits<char>::to_int_type(char_to_test);
-  if (first_char <= 0x7F) {
-    // Single byte character
-    return 1;
-  } else if ((first_char & 0xE0) == 0xC0) {
-    // Two byte character
-    return 2;
-  } else if ((first_char & 0xF0) == 0xE0) {
-    // Three byte character
-    return 3;
-  } else if ((first_char & 0xF0) == 0xF0) {
-    // Four byte character
-    return 4;
-  } else {
-    // Invalid character code.
-    return 0;
-  }
+  do {
+    wrote = false;
+    for (uint8_t bus = 0; bus < this->flush_cursors_.size(); bus++) {
+      wrote |= this->flush_bus_(bus);
+    }
+  } while (wrote);
 }
 
 /***********************************
- *Clear the contents of the buffer.
- *  This function clears the buffer that is directly sent to the devices.
- *  It should be called before adding new data to the buffer.
+ *Make the next write of the queued frames of the displays on one bus, within what is left of its byte budget. This
+ * bounds the time that a long display chain can hold up loop(). Whatever does not fit is sent in the following calls.
+ * The displays take turns, starting with the one that was not finished last time, so that a display late in the
+ * chain is not starved.
+ *
+ *  bus: the index of the bus.
+ *
+ * Returns: true if a write was made, false if the bus has nothing left to send or is out of budget.
  ************************************/
-void HT16k33CharComponent::clear_buffer_() {
-  for (unsigned char &i : this->buffer_) {
-    i = 0x00;
+bool HT16k33CharComponent::flush_bus_(uint8_t bus) {
+  uint8_t start = this->bus_start_[bus];
+  uint8_t size = this->bus_start_[bus + 1] - start;
+  uint8_t &cursor = this->flush_cursors_[bus];
+  uint8_t count;
+
+  for (count = 0; count < size; count++) {
+    if (cursor >= size) {
+      cursor = 0;
+    }
+    HT16k33Display &display = this->displays_[this->bus_order_[start + cursor]];
+    if (display.frame_pending) {
+      switch (this->flush_display_(display)) {
+        case HT16K33_FLUSH_SENT:
+          // Stay on this display. Its next span is sent on the next turn of the bus.
+          return true;
+        case HT16K33_FLUSH_NO_BUDGET:
+          // Continue with this display next time.
+          return false;
+        default:
+          break;
+      }
+    }
+    cursor++;
   }
+  return false;
 }
 
 /***********************************
- * Write the message characters to the display send buffer and send to the display indicated. This function
- * works for all the devices that I have tested. This function relies on two device specific functions:
- * handle_special_char() and write_to_buffer().
+ *Send the next part of the queued frame of a display. Only the bytes that differ from what was last written to the
+ * display RAM are sent. The HT16K33 auto-increments its RAM address pointer after each byte, so each changed span is
+ * sent as one write that starts with the RAM address of the first changed byte. If nothing changed, nothing is sent.
  *
- *  display: the display device to send the buffer to.
- *
- *  position: The position in the message buffer of the first character to display.
+ *  display: the display to send the frame to. A write that does not fit in the byte budget of its bus is not started.
  *
- * Returns: the location in the message buffer of the next character. This is the position to
- *          send to the next display if one is present.
+ * Returns: HT16K33_FLUSH_SENT if a write was made, HT16K33_FLUSH_DONE if the frame was completely sent, or
+ *          HT16K33_FLUSH_NO_BUDGET if the next write does not fit in the budget.
  ************************************/
-uint16_t HT16k33CharComponent::send_to_display_common_(i2c::I2CDevice *display, uint16_t position) {
-  uint8_t char_length;
-  uint8_t digit_number;
-  uint16_t char_buffer_location;
-  bool special_character_found;
-  std::string char_to_find;
-
-  // Clear any old data from the buffer.
-  this->clear_buffer_();
-
-  this->buffer_[0] = HT16K33_DISPLAY_DATA_ADDRESS;
-  char_buffer_location = position;
-  digit_number = 0;
-  special_character_found = false;
+uint8_t HT16k33CharComponent::flush_display_(HT16k33Display &display) {
+  uint8_t span[HT16K33_FRAME_SIZE];
+  uint8_t span_start;
+  uint8_t span_end;
+  uint8_t i;
 
-  while (digit_number < this->num_chars_per_display_) {
-    if (char_buffer_location >= this->message_buffer_.length()) {
-      // char_buffer_location is past the end of the character buffer.
-      if (this->continuous_) {
-        // We want a continuous display where the message starts over immediately.
-        char_buffer_location = 0;
-      } else {
-        // Blank the digits past the end of the display.
-        this->write_to_buffer(0, digit_number);
-        digit_number++;
-      }
+  if (!display.ram_valid) {
+    // We don't know what is in the display RAM. Send the whole frame.
+    if (!this->charge_(display, HT16K33_FRAME_SIZE)) {
+      return HT16K33_FLUSH_NO_BUDGET;
     }
-
-    else {
-      // The character to find is within the bounds of the buffer array.
-      char_length = this->get_next_char_(char_buffer_location, &char_to_find);
-      if (char_length == 0) {
-        // I don't think this is possible. If it is, display a blank character.
-        char_to_find.resize(1);
-        char_to_find.clear();
-        char_to_find.push_back(' ');
-        char_buffer_location = char_buffer_location + 1;
-      } else {
-        char_buffer_location = char_buffer_location + char_length;
-      }
-
-      auto it = this->char_map_.find(char_to_find);
-      if (it != this->char_map_.end()) {
-        // We found the character we want to write in the character map. Write that character code to the display buffer
-        this->write_to_buffer(it->second, digit_number);
-        special_character_found = false;
-        digit_number++;
-      } else {
-        // The character we were looking for was not in the character map. Check if the character is a special
-        // character. Special characters such as '.' and ':' have separate LEDs on the display. These
-        // characters are only valid at certain locations in the display. A special character in an invalid
-        // location will be treated the same way as an invalid character. In the case of an invalid character,
-        // that location in the display will be left blank. only one special character will be evaulated per
-        // location on the display.
-        if (!special_character_found) {
-          switch (this->handle_special_char(char_to_find.at(0), digit_number)) {
-            case SPECIAL_CHAR_FOUND:
-              special_character_found = true;
-              continue;
-            case SPECIAL_CHAR_FOUND_ADVANCE:
-              // This case covers if we are scrolling the display and the first character in the first display is a
-              // special character. In this instance, we want to skip over that character, or the scrolling will end
-              // up choppy. To do this, we increment the first_char_location_ variable.
-              special_character_found = true;
-              if ((this->fist_char_location_ == (char_buffer_location - 1)) &&
-                  (this->scroll_state_ != HT16K33_SCROLL_STATE_STATIC) &&
-                  (this->scroll_state_ != HT16K33_SCROLL_STATE_STOPPED)) {
-                this->fist_char_location_++;  // All special characters are single byte only.
-              }
-              continue;
-          }
-        }
-
-        // The character we were looking for is not in the character map or a speical character, blank this digit.
-        this->write_to_buffer(0, digit_number);
-        special_character_found = false;
-        digit_number++;
-      }
+    display.frame[0] = HT16K33_DISPLAY_DATA_ADDRESS;
+    if (this->write_display_(display, display.frame, HT16K33_FRAME_SIZE) == i2c::ERROR_OK) {
+      memcpy(display.ram, display.frame, HT16K33_FRAME_SIZE);
+      display.ram_valid = true;
     }
+    // If the write failed, the frame is dropped. The next frame is sent in full.
+    display.frame_pending = false;
+    return HT16K33_FLUSH_SENT;
   }
 
-  // We may be able to have special characters after the last digit, Handle that here.
-  if (!(char_buffer_location >= this->message_buffer_.length())) {
-    this->get_next_char_(char_buffer_location, &char_to_find);
-    if (this->handle_special_char(char_to_find.at(0), digit_number) == SPECIAL_CHAR_FOUND) {
-      char_buffer_location++;
-    }
+  // frame[0] is the display data address. The display RAM starts at frame[1]. The spans that were already sent are in
+  // display.ram, so this finds the next one.
+  i = 1;
+  while ((i < HT16K33_FRAME_SIZE) && (display.frame[i] == display.ram[i])) {
+    i++;
+  }
+  if (i >= HT16K33_FRAME_SIZE) {
+    display.frame_pending = false;
+    return HT16K33_FLUSH_DONE;
   }
 
-  display->write(this->buffer_, 16);
-  return char_buffer_location;
-}
-
-/***********************************
- *Add a character to the character map.
- *  This function should correctly handle UTF-8 mutibyte characters.
- *  If char_to_add is more than one character long, only the first character will be used.
- *
- *  char_to_add: The character to add to the map
- *
- *  char_code: The code that represents which LEDs should be light for this character.
- ************************************/
-void HT16k33CharComponent::add_char(const char *char_to_add, uint16_t char_code) {
-  std::string lookup_string = char_to_add;
+  // Found a changed byte. Extend the span up to the last changed byte that is not separated from the rest of the span
+  // by more than HT16K33_SPAN_MERGE_GAP unchanged bytes.
+  span_start = i;
+  span_end = i + 1;
+  for (i = span_end; (i < HT16K33_FRAME_SIZE) && ((i - span_end) <= HT16K33_SPAN_MERGE_GAP); i++) {
+    if (display.frame[i] != display.ram[i]) {
+      span_end = i + 1;
+    }
+  }
 
-  if (lookup_string.length() > this->char_len_(char_to_add[0])) {
-    // If the string contains more than one character, we truncate to the first character only.
-    lookup_string.resize(this->char_len_(char_to_add[0]));
+  if (!this->charge_(display, span_end - span_start + 1)) {
+    return HT16K33_FLUSH_NO_BUDGET;
   }
 
-  this->char_map_[lookup_string] = char_code;
+  span[0] = HT16K33_DISPLAY_DATA_ADDRESS + (span_start - 1);
+  memcpy(&span[1], &display.frame[span_start], span_end - span_start);
+  if (this->write_display_(display, span, span_end - span_start + 1) == i2c::ERROR_OK) {
+    memcpy(&display.ram[span_start], &display.frame[span_start], span_end - span_start);
+  } else {
+    // The write failed. We no longer know what is in the display RAM, so the next frame is sent in full.
+    display.ram_valid = false;
+    display.frame_pending = false;
+  }
+  return HT16K33_FLUSH_SENT;
 }
 
 /***********************************
@@ -530,18 +1989,18 @@ void HT16k33CharComponent::add_char(const char *char_to_add, uint16_t char_code)
  *
  *  str:          The string to put in the buffer.
  *
+ *  len:          The number of bytes in str. str does not need to be null terminated.
+ *
  *  clear_buffer: Boolean. Set to true to clear the display buffer before writing the string.
  *
  *  Returns the number of bytes written to the buffer. Note that the number of bytes in the buffer
  *    is limited by this->char_buffer_max_size_. If str is a longer string, or adding it would make the
  *    total buffer length (in bytes) exceede char_buffer_max_size_, the string is truncated to prevent this.
  ************************************/
-uint8_t HT16k33CharComponent::print(uint16_t start_pos, bool clear_buffer, const char *str) {
-  size_t old_message_size = this->message_buffer_.length();
-  uint16_t len = strlen(str);
-
+uint16_t HT16k33CharComponent::print(uint16_t start_pos, bool clear_buffer, const char *str, size_t len) {
   if (clear_buffer) {
     this->message_buffer_.clear();
+    this->message_changed_ = true;
   }
 
   if (start_pos >= this->char_buffer_max_size_) {
@@ -563,16 +2022,44 @@ uint8_t HT16k33CharComponent::print(uint16_t start_pos, bool clear_buffer, const
   } else {
     this->message_buffer_.insert(start_pos, str, len);
   }
-
-  if ((this->message_buffer_.size() != old_message_size) && (this->scroll_state_ != HT16K33_SCROLL_STATE_STATIC)) {
-    // If the new message is a different size from the old one, we restart the scrolling.
-    this->scroll_state_ = HT16K33_SCROLL_STATE_FIRST_START;
-    this->fist_char_location_ = 0;
-  }
+  this->message_changed_ = true;
 
   return len;
 }
 
+/***********************************
+ *Write a null terminated character string to the display buffer.
+ *
+ *  start_pos:    The position to place the first character in the string. Position 0 is the start
+ *                of the display buffer.
+ *
+ *  clear_buffer: Boolean. Set to true to clear the display buffer before writing the string.
+ *
+ *  str:          The string to put in the buffer.
+ *
+ *  Returns the number of bytes written to the buffer.
+ ************************************/
+uint16_t HT16k33CharComponent::print(uint16_t start_pos, bool clear_buffer, const char *str) {
+  return this->print(start_pos, clear_buffer, str, strlen(str));
+}
+
+/***********************************
+ *Write a string view to the display buffer. The length is already known, so the string is not scanned for a null
+ *  terminator.
+ *
+ *  start_pos:    The position to place the first character in the string. Position 0 is the start
+ *                of the display buffer.
+ *
+ *  clear_buffer: Boolean. Set to true to clear the display buffer before writing the string.
+ *
+ *  str:          The string to put in the buffer.
+ *
+ *  Returns the number of bytes written to the buffer.
+ ************************************/
+uint16_t HT16k33CharComponent::print(uint16_t start_pos, bool clear_buffer, std::string_view str) {
+  return this->print(start_pos, clear_buffer, str.data(), str.size());
+}
+
 /***********************************
  *Write a character string to the start of the display buffer.
  *
@@ -582,7 +2069,7 @@ uint8_t HT16k33CharComponent::print(uint16_t start_pos, bool clear_buffer, const
  *
  *  Returns the number of bytes written to the buffer.
  ************************************/
-uint8_t HT16k33CharComponent::print(bool clear_buffer, const char *str) { return this->print(0, clear_buffer, str); }
+uint16_t HT16k33CharComponent::print(bool clear_buffer, const char *str) { return this->print(0, clear_buffer, str); }
 
 /***********************************
  *Implements a printf to write a formatted string to the display buffer.
@@ -594,25 +2081,23 @@ uint8_t HT16k33CharComponent::print(bool clear_buffer, const char *str) { return
  *
  *  The remaining parameters are the normal parameters for printf.
  *
+ *  The text is formatted once, straight into the message buffer.
+ *
  *  Returns the number of bytes written to the buffer.
  ************************************/
-uint8_t HT16k33CharComponent::printf(uint16_t start_pos, bool clear_buffer, const char *format, ...) {
-  va_list arg;
-  va_start(arg, format);
-
-  // Determine how long of a string we need to hold the output of printf.
-  int len = vsnprintf(NULL, 0, format, arg) + 1;  // Add 1 for the null terminator
-
-  // Limit the output of printf to the defined max size.
-  if (len > this->char_buffer_max_size_) {
-    len = this->char_buffer_max_size_ + 1;  // Add 1 for the null terminator
+uint16_t HT16k33CharComponent::printf(uint16_t start_pos, bool clear_buffer, const char *format, ...) {
+  size_t room;
+  size_t text_start = this->begin_write_(start_pos, clear_buffer, &room);
+  if (room == 0) {
+    return 0;
   }
 
-  char buffer[len];
-  vsnprintf(buffer, sizeof(buffer), format, arg);
+  va_list arg;
+  va_start(arg, format);
+  int len = vsnprintf(&this->message_buffer_[text_start], room + 1, format, arg);
   va_end(arg);
 
-  return this->print(start_pos, clear_buffer, buffer);
+  return this->end_write_(start_pos, text_start, len < 0 ? 0 : len, room);
 }
 
 /***********************************
@@ -627,12 +2112,106 @@ uint8_t HT16k33CharComponent::printf(uint16_t start_pos, bool clear_buffer, cons
  *
  *  time: the time object to write.
  *
+ *  The time is formatted straight into the message buffer. strftime() writes nothing if the text does not fit in
+ *    the room that is left, so that is what is printed then.
+ *
+ *  Returns the number of bytes written to the buffer.
+ ************************************/
+uint16_t HT16k33CharComponent::strftime(uint16_t start_pos, bool clear_buffer, const char *format, ESPTime time) {
+  size_t room;
+  size_t text_start = this->begin_write_(start_pos, clear_buffer, &room);
+  if (room == 0) {
+    return 0;
+  }
+
+  size_t len = time.strftime(&this->message_buffer_[text_start], room + 1, format);
+  return this->end_write_(start_pos, text_start, len, room);
+}
+
+/***********************************
+ *Makes room for formatted text at the end of the message buffer. printf() and strftime() write into it in place,
+ *  then end_write_() moves the text to start_pos.
+ *
+ *  start_pos:    The position the text will be placed at.
+ *
+ *  clear_buffer: Boolean. Set to true to clear the display buffer first.
+ *
+ *  room:         Set to the number of bytes that fit at start_pos. The buffer has one more byte after them for the
+ *                null terminator. 0 if nothing can be written.
+ *
+ *  Returns the offset in the message buffer of the text.
+ ************************************/
+size_t HT16k33CharComponent::begin_write_(uint16_t start_pos, bool clear_buffer, size_t *room) {
+  if (clear_buffer) {
+    this->message_buffer_.clear();
+    this->message_changed_ = true;
+  }
+
+  if (start_pos >= this->char_buffer_max_size_) {
+    // We can't write past the end of the buffer
+    *room = 0;
+    return 0;
+  }
+
+  // If the string is too short, add blank spaces at the start until we get to start_pos.
+  if (start_pos > this->message_buffer_.size()) {
+    this->message_buffer_.resize(start_pos, ' ');
+  }
+
+  // Unless the text is inserted into the middle of the message, this stays within the room reserved by
+  // set_buffer_max_size().
+  size_t text_start = this->message_buffer_.size();
+  *room = this->char_buffer_max_size_ - start_pos;
+  this->message_buffer_.resize(text_start + *room + 1);
+  return text_start;
+}
+
+/***********************************
+ *Finishes text written after begin_write_(). Drops the unused room and moves the text to start_pos.
+ *
+ *  start_pos:  The position to place the text at.
+ *
+ *  text_start: The offset returned by begin_write_().
+ *
+ *  len:        The length of the formatted text. This may be more than what fit in the room.
+ *
+ *  room:       The room returned by begin_write_().
+ *
  *  Returns the number of bytes written to the buffer.
  ************************************/
-uint8_t HT16k33CharComponent::strftime(uint16_t start_pos, bool clear_buffer, const char *format, ESPTime time) {
-  std::string time_string_buffer;
-  time_string_buffer = time.strftime(format);
-  return this->print(start_pos, clear_buffer, time_string_buffer.c_str());
+uint16_t HT16k33CharComponent::end_write_(uint16_t start_pos, size_t text_start, size_t len, size_t room) {
+  bool truncated = len > room;
+  if (truncated) {
+    len = room;
+  }
+  this->message_buffer_.resize(text_start + len);
+
+  if (truncated) {
+    // Same as print(): the text fills the buffer up to the max size, so the rest of the message is dropped.
+    this->message_buffer_.erase(start_pos, text_start - start_pos);
+  } else if (start_pos < text_start) {
+    // The text goes into the middle of the message. Rotate it into place instead of copying it.
+    std::rotate(this->message_buffer_.begin() + start_pos, this->message_buffer_.begin() + text_start,
+                this->message_buffer_.end());
+  }
+  this->message_changed_ = true;
+
+  return len;
+}
+
+/***********************************
+ *Restarts the scrolling when the message that was printed has a different length than the message on the displays.
+ * This runs once the lambda is done, so a message that is put together from several prints is only compared as a
+ * whole.
+ ************************************/
+void HT16k33CharComponent::restart_scroll_() {
+  if (this->message_changed_ && (this->message_buffer_.size() != this->compiled_message_.size()) &&
+      (this->scroll_state_ != HT16K33_SCROLL_STATE_STATIC)) {
+    // If the new message is a different size from the old one, we restart the scrolling.
+    this->scroll_state_ = HT16K33_SCROLL_STATE_FIRST_START;
+    this->fist_char_location_ = 0;
+    this->enable_loop();
+  }
 }
 
 /***********************************
@@ -651,8 +2230,8 @@ uint8_t HT16k33CharComponent::strftime(uint16_t start_pos, bool clear_buffer, co
  *
  *  Returns the number of bytes written to the buffer.
  ************************************/
-uint8_t HT16k33CharComponent::clock_display(uint16_t start_pos, bool clear_buffer, bool show_leading_zero,
-                                            bool use_ampm, ESPTime time) {
+uint16_t HT16k33CharComponent::clock_display(uint16_t start_pos, bool clear_buffer, bool show_leading_zero,
+                                             bool use_ampm, ESPTime time) {
   char buffer[6];
 
   if (use_ampm) {
@@ -669,5 +2248,133 @@ uint8_t HT16k33CharComponent::clock_display(uint16_t start_pos, bool clear_buffe
   return this->print(start_pos, clear_buffer, buffer);
 }
 
+#ifdef USE_TIME
+/***********************************
+ *Runs at the start of each period of the clock. The period boundaries are taken from the system clock, which the
+ * time component keeps in sync, so the time is shown when it changes rather than at the next update(). If the time
+ * did not change, update_display() finds nothing to do. If only some digits changed, only their bytes are sent.
+ *
+ * If the colon blinks, this also runs halfway through each second to turn the colon off.
+ ************************************/
+void HT16k33CharComponent::clock_tick_() {
+  struct timeval now;
+  uint32_t tick = this->clock_blink_colon_ ? 500 : this->clock_period_;
+  uint32_t ms;
+
+  gettimeofday(&now, nullptr);
+  now.tv_usec += HT16K33_CLOCK_EARLY_MARGIN * 1000;
+  if (now.tv_usec >= 1000000) {
+    now.tv_sec++;
+    now.tv_usec -= 1000000;
+  }
+  ms = now.tv_usec / 1000;
+
+  ESPTime time = ESPTime::from_epoch_local(now.tv_sec);
+  if (time.is_valid()) {
+    if (!this->clock_blink_colon_ || (ms < 500)) {
+      // Turn the colon on first, so that it is sent together with the digits that changed.
+      this->show_colon_(true);
+      this->strftime(0, true, this->clock_format_.c_str(), time);
+      if (!this->clock_leading_zero_ && (this->message_buffer_[0] == '0')) {
+        // Clear leading zero
+        this->message_buffer_[0] = ' ';
+      }
+      this->refresh_display_();
+    } else {
+      this->show_colon_(false);
+    }
+    // update_display() has nothing to send if the time did not change, but the colon may have. loop() sends it.
+    this->enable_loop();
+  }
+
+  // The next tick is at the start of the next period. The periods divide a minute, so they line up with the minutes.
+  // ms is ahead by the margin, which is added back.
+  ms += (now.tv_sec % 60) * 1000;
+  this->set_timeout("clock", tick - (ms % tick) + HT16K33_CLOCK_EARLY_MARGIN, [this]() { this->clock_tick_(); });
+}
+#endif
+
+#ifdef USE_SENSOR
+/***********************************
+ *Map a reading of the auto brightness sensor to a brightness through the curve. Readings outside of the curve get
+ * the brightness of the nearest end.
+ *
+ *  value: The reading of the sensor.
+ *
+ * Returns: The brightness, from 1 to 16, not rounded to a step.
+ ************************************/
+float HT16k33CharComponent::auto_brightness_curve_at_(float value) const {
+  const std::vector<HT16k33BrightnessPoint> &curve = this->auto_brightness_curve_;
+  size_t i;
+
+  if (value <= curve.front().value) {
+    return curve.front().brightness;
+  }
+  for (i = 1; i < curve.size(); i++) {
+    if (value < curve[i].value) {
+      return curve[i - 1].brightness + (curve[i].brightness - curve[i - 1].brightness) *
+                                           (value - curve[i - 1].value) / (curve[i].value - curve[i - 1].value);
+    }
+  }
+  return curve.back().brightness;
+}
+
+/***********************************
+ *Handle a new reading of the auto brightness sensor. The target brightness only changes if the reading maps to more
+ * than the hysteresis past the middle between the target and the next step, so a reading that wobbles around the
+ * middle between two steps does not change it back and forth.
+ *
+ *  value: The reading of the sensor.
+ ************************************/
+void HT16k33CharComponent::auto_brightness_reading_(float value) {
+  float brightness;
+
+  if (std::isnan(value) || this->auto_brightness_curve_.empty()) {
+    return;
+  }
+
+  brightness = this->auto_brightness_curve_at_(value);
+  if ((this->auto_brightness_target_ == 0) ||
+      (std::fabs(brightness - this->auto_brightness_target_) > 0.5f + this->auto_brightness_hysteresis_)) {
+    this->auto_brightness_target_ = clamp<long>(std::lround(brightness), 1, 16);
+  }
+  this->auto_brightness_step_();
+}
+
+/***********************************
+ *Move the brightness one step toward the target, if the step interval has passed since the last step. Otherwise,
+ * or if the target is more than one step away, the next step is scheduled. The first reading sets the brightness
+ * directly. The dimming register of a chip is only written if its value changes, see commit_registers_().
+ ************************************/
+void HT16k33CharComponent::auto_brightness_step_() {
+  uint32_t now = millis();
+  uint32_t elapsed = now - this->auto_brightness_last_step_;
+
+  if (this->auto_brightness_level_ == this->auto_brightness_target_) {
+    return;
+  }
+  if ((this->auto_brightness_level_ != 0) && (elapsed < this->auto_brightness_step_interval_)) {
+    this->set_timeout("auto_brightness", this->auto_brightness_step_interval_ - elapsed,
+                      [this]() { this->auto_brightness_step_(); });
+    return;
+  }
+
+  if (this->auto_brightness_level_ == 0) {
+    this->auto_brightness_level_ = this->auto_brightness_target_;
+  } else if (this->auto_brightness_level_ < this->auto_brightness_target_) {
+    this->auto_brightness_level_++;
+  } else {
+    this->auto_brightness_level_--;
+  }
+  this->auto_brightness_last_step_ = now;
+  this->brightness(this->auto_brightness_level_);
+
+  if (this->auto_brightness_level_ != this->auto_brightness_target_) {
+    this->set_timeout("auto_brightness", this->auto_brightness_step_interval_,
+                      [this]() { this->auto_brightness_step_(); });
+  }
+}
+#endif
+
 }  // namespace ht16k33_char
 }  // namespace esphome
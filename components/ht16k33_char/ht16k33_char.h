@@ -1,9 +1,26 @@
 #pragma once
 
+#include <algorithm>
+#include <string_view>
+
+#include "esphome/core/automation.h"
 #include "esphome/core/component.h"
+#include "esphome/core/defines.h"
+#include "esphome/core/gpio.h"
+#include "esphome/core/helpers.h"
 #include "esphome/core/time.h"
 #include "esphome/components/i2c/i2c.h"
 
+#ifdef USE_SENSOR
+#include "esphome/components/sensor/sensor.h"
+#endif
+#ifdef USE_BINARY_SENSOR
+#include "esphome/components/binary_sensor/binary_sensor.h"
+#endif
+#ifdef USE_TIME
+#include "esphome/components/time/real_time_clock.h"
+#endif
+
 namespace esphome {
 namespace ht16k33_char {
 
@@ -19,22 +36,343 @@ static const uint8_t HT16K33_DISPLAY_OFF = 0x00;
 static const uint8_t HT16K33_DISPLAY_ON = 0x01;
 static const uint8_t HT16K33_MODE_STANDBY = 0x00;
 static const uint8_t HT16K33_MODE_NORMAL = 0x01;
-
-// Return codes from handle_special_char_()
-static const uint8_t SPECIAL_CHAR_NOT_FOUND = 0x00;      // Not a special char.
-static const uint8_t SPECIAL_CHAR_FOUND = 0x01;          // Special char found and handled
-static const uint8_t SPECIAL_CHAR_FOUND_ADVANCE = 0x02;  // Special char found and handled, advance display if the
-                                                         // special char was in the first position of the first display.
+static const uint8_t HT16K33_ROW_INT_INT_OUTPUT = 0x01;  // Use the ROW15/INT pin as the active low INT output.
+
+// Each chip scans a matrix of 3 key commons (KS0-KS2) by 13 keys (K1-K13). The key data RAM holds two bytes for each
+// common, with K1 in bit 0 of the first byte. Keys are numbered (common * 13) + (K - 1), so K1 of KS0 is key 0 and K13
+// of KS2 is key 38.
+static const uint8_t HT16K33_KEY_DATA_SIZE = 6;
+static const uint8_t HT16K33_KEYS_PER_COMMON = 13;
+static const uint8_t HT16K33_NUM_KEYS = 39;
+
+// Size of the frame sent to each display. This is the display data address byte followed by the 15 bytes of display
+// RAM that are used by the displays.
+static const uint8_t HT16K33_FRAME_SIZE = 16;
+
+// When sending the changed parts of a frame, changed spans separated by this many unchanged bytes or less are merged
+// into one write. Each write costs a start condition, the I2C address and the display data address, so it is cheaper
+// to resend a couple of unchanged bytes than to start a new write.
+static const uint8_t HT16K33_SPAN_MERGE_GAP = 2;
+
+// What flush_display_() did.
+static const uint8_t HT16K33_FLUSH_DONE = 0;       // The frame is completely sent.
+static const uint8_t HT16K33_FLUSH_SENT = 1;       // One write was made. There may be more to send.
+static const uint8_t HT16K33_FLUSH_NO_BUDGET = 2;  // The next write does not fit in the byte budget.
+
+// The types of special characters. A special character is not in the font, but lights a segment of the display.
+static const uint8_t SPECIAL_CHAR_POSITIONAL = 0x01;       // Only valid at certain positions, such as a colon
+static const uint8_t SPECIAL_CHAR_ATTACH_PREVIOUS = 0x02;  // Lights a segment of the digit before it, such as a period
+static const uint8_t SPECIAL_CHAR_ATTACH_NEXT = 0x03;      // Lights a segment of the digit after it
+
+// The layout tables are generated by display.py. Each one is the TABLE of a struct that HT16k33CharDevice is
+// instantiated with, so it is unpacked at compile time and never stored on the device. A layout table describes where
+// the characters are drawn in the display RAM of a device. It is an array of 16-bit words:
+//   [0]              The number of digits of one display, N. At most HT16K33_MAX_DIGITS.
+//   [1, 1 + N)       For each digit, its frame index in the low byte, and the shift of its segments in the high byte.
+//   [1 + N, 17 + N)  For each bit of the character code, the segment that it lights: (byte << 3) | bit. byte is added
+//                    to the frame index of the digit, and bit to its shift. HT16K33_SEGMENT_NONE if it lights nothing.
+//   [17 + N]         The number of special characters, M. At most HT16K33_MAX_SPECIAL_CHARS.
+//   [18 + N, ...)    (N + 4) words for each special character: The character, its SPECIAL_CHAR_* type, and the bits it
+//                    adds to the character code of a digit if it attaches to one. Then, for each position from 0 to N,
+//                    what a POSITIONAL character lights there: (frame index << 8) | bits, or 0 if it is not valid at
+//                    that position.
+static const uint8_t HT16K33_MAX_DIGITS = 8;
+static const uint8_t HT16K33_MAX_SPECIAL_CHARS = 4;
+static const uint8_t HT16K33_SEGMENT_NONE = 0xFF;
+
+// The font tables are generated by display.py and stored in flash. A font table is an array of 16-bit words:
+//   [0, 128)    The character codes for the ASCII characters 0x00-0x7F.
+//   [128, 136)  A bitmap of the ASCII characters that are in the font. Bit n of word m is set if character
+//               (m * 16 + n) is in the font.
+//   [136]       The number of non-ASCII characters in the font.
+//   [137, ...)  Three words for each non-ASCII character, sorted by code point: The upper and lower 16 bits of the
+//               unicode code point, then the character code.
+static const uint16_t HT16K33_FONT_ASCII_SIZE = 128;
+static const uint16_t HT16K33_FONT_ASCII_BITMAP = 128;
+static const uint16_t HT16K33_FONT_EXTENDED_COUNT = 136;
+static const uint16_t HT16K33_FONT_EXTENDED_START = 137;
+static const uint16_t HT16K33_FONT_EXTENDED_ENTRY_SIZE = 3;
+
+// Transitions that can be shown when the message changes.
+static const uint8_t HT16K33_TRANSITION_NONE = 0;
+static const uint8_t HT16K33_TRANSITION_WIPE = 1;   // The new message replaces the old one digit by digit.
+static const uint8_t HT16K33_TRANSITION_BUILD = 2;  // The new message is drawn one segment at a time.
+static const uint8_t HT16K33_TRANSITION_FADE = 3;   // The old message fades out and the new one fades in.
+static const uint8_t HT16K33_TRANSITION_FLASH = 4;  // The new message blinks until the transition ends.
+
+// When the lambda of a playlist entry runs. See HT16k33PlaylistEntry.
+static const uint8_t HT16K33_REFRESH_ALWAYS = 0;   // When the entry is shown, and at every update while it is shown.
+static const uint8_t HT16K33_REFRESH_ON_SHOW = 1;  // Each time the entry is shown.
+static const uint8_t HT16K33_REFRESH_ONCE = 2;     // The first time the entry is shown only.
+
+// Keyframe types. See HT16k33Keyframe.
+static const uint8_t HT16K33_KEYFRAME_FRAME = 0;    // Send frame to a chip.
+static const uint8_t HT16K33_KEYFRAME_DIMMING = 1;  // Set the dimming of all chips.
+static const uint8_t HT16K33_KEYFRAME_BLINK = 2;    // Set the blink rate of all chips.
+
+// A DIMMING or BLINK keyframe with this value goes back to the dimming or blink rate set with brightness() or
+// set_blink().
+static const uint8_t HT16K33_NO_OVERRIDE = 0xFF;
+
+// What stream_push() does when the stream is full.
+static const uint8_t HT16K33_STREAM_DROP_NEWEST = 0;  // The characters that do not fit are dropped.
+static const uint8_t HT16K33_STREAM_DROP_OLDEST = 1;  // The oldest characters are dropped to make room.
+
+// The channel of a display that is not behind the I2C multiplexer.
+static const uint8_t HT16K33_NO_CHANNEL = 0xFF;
+
+// A clock tick that runs this many ms before the start of its period, because the scheduler and the system clock do
+// not count time quite the same, is taken to be on time.
+static const uint32_t HT16K33_CLOCK_EARLY_MARGIN = 10;
+
+// The code point used for bytes in the message that are not valid UTF-8. This is the unicode replacement character.
+static const uint32_t HT16K33_INVALID_CODEPOINT = 0xFFFD;
 
 class HT16k33CharComponent;
 
+// One character of the compiled message.
+struct HT16k33Glyph {
+  uint16_t char_code;  // The character code, including any special characters that light a segment of this digit.
+  uint8_t special;     // For a POSITIONAL special character, 1 + its index in the layout. 0 for a normal digit.
+};
+
+// Spreads the bits of a nibble to the bytes of a word: Byte n is bit n of the nibble. See render_frame_().
+static const uint32_t HT16K33_NIBBLE_SPREAD[16] = {
+    0x00000000, 0x00000001, 0x00000100, 0x00000101, 0x00010000, 0x00010001, 0x00010100, 0x00010101,
+    0x01000000, 0x01000001, 0x01000100, 0x01000101, 0x01010000, 0x01010001, 0x01010100, 0x01010101,
+};
+
+// The layout table of the device, unpacked by unpack_layout() so that render_frame_() can look everything up directly.
+struct HT16k33Layout {
+  uint8_t num_digits;
+  uint8_t digit_index[HT16K33_MAX_DIGITS];  // The frame index of each digit.
+  uint8_t digit_shift[HT16K33_MAX_DIGITS];  // The shift of the segment bits of each digit.
+  uint8_t segments[16];                     // The segment that each bit of the character code lights.
+  bool direct;                              // True if bit n of the character code is bit n % 8 of byte n / 8 of the
+                                            // digit, so that the character code can be written as it is.
+  uint16_t segment_mask;                    // The bits of the character code that light a segment.
+  bool bit_sliced;                          // True if all digits are written together by render_frame_().
+  uint8_t num_special_chars;
+  bool positional_specials;  // True if a special character is POSITIONAL, so that glyphs may have special set.
+  char special_chars[HT16K33_MAX_SPECIAL_CHARS];
+  uint8_t special_types[HT16K33_MAX_SPECIAL_CHARS];
+  uint16_t special_bits[HT16K33_MAX_SPECIAL_CHARS];  // The bits that an ATTACH character adds to the character code.
+  // Where a POSITIONAL character lights, by character and position: the frame index, 0 if it is not valid there, and
+  // the bits.
+  uint8_t special_index[HT16K33_MAX_SPECIAL_CHARS][HT16K33_MAX_DIGITS + 1];
+  uint8_t special_mask[HT16K33_MAX_SPECIAL_CHARS][HT16K33_MAX_DIGITS + 1];
+};
+
+// Unpacks a layout table, see the description of the layout tables above. This runs at compile time for the layout
+// that HT16k33CharDevice is instantiated with.
+constexpr HT16k33Layout unpack_layout(const uint16_t *table) {
+  HT16k33Layout l{};
+  uint16_t position = 0;
+
+  l.num_digits = *table++;
+  l.direct = true;
+  for (uint8_t digit = 0; digit < l.num_digits; digit++) {
+    position = *table++;
+    l.digit_index[digit] = position & 0xFF;
+    l.digit_shift[digit] = position >> 8;
+    l.direct = l.direct && (l.digit_shift[digit] == 0);
+  }
+
+  for (uint8_t bit = 0; bit < 16; bit++) {
+    l.segments[bit] = *table++;
+    if (l.segments[bit] != HT16K33_SEGMENT_NONE) {
+      l.segment_mask |= 1 << bit;
+      l.direct = l.direct && (l.segments[bit] == bit);
+    }
+  }
+
+  // In a bit sliced layout, the digits share the same bytes, and each digit has one bit in the low and one bit in the
+  // high nibble of each byte. Segments n and n + 8 are in the same byte.
+  l.bit_sliced = !l.direct && (l.num_digits > 0);
+  for (uint8_t digit = 0; digit < l.num_digits; digit++) {
+    l.bit_sliced = l.bit_sliced && (l.digit_index[digit] == l.digit_index[0]) && (l.digit_shift[digit] < 4);
+  }
+  for (uint8_t bit = 0; bit < 8; bit++) {
+    l.bit_sliced = l.bit_sliced && ((l.segments[bit] & 0x07) == 0) && (l.segments[bit + 8] == (l.segments[bit] | 0x04));
+  }
+
+  l.num_special_chars = *table++;
+  for (uint8_t special = 0; special < l.num_special_chars; special++) {
+    l.special_chars[special] = *table++;
+    l.special_types[special] = *table++;
+    l.positional_specials = l.positional_specials || (l.special_types[special] == SPECIAL_CHAR_POSITIONAL);
+    l.special_bits[special] = *table++;
+    for (uint8_t digit = 0; digit <= l.num_digits; digit++) {
+      position = *table++;
+      l.special_index[special][digit] = position >> 8;
+      l.special_mask[special][digit] = position & 0xFF;
+    }
+  }
+  return l;
+}
+
+// A fixed size ring buffer of glyphs for the streaming ticker. Glyphs are added at the back and consumed from the
+// front, so the memory is allocated once and used over and over.
+class HT16k33GlyphRing {
+ public:
+  void init(size_t capacity, uint8_t drop_policy) {
+    this->glyphs_.resize(capacity);
+    this->drop_policy_ = drop_policy;
+  }
+
+  size_t size() const { return this->size_; }
+  size_t capacity() const { return this->glyphs_.size(); }
+  bool empty() const { return this->size_ == 0; }
+  const HT16k33Glyph &operator[](size_t index) const {
+    return this->glyphs_[(this->head_ + index) % this->glyphs_.size()];
+  }
+
+  // Adds a glyph. If the ring is full, the drop policy decides which glyph is lost.
+  void push_back(const HT16k33Glyph &glyph) {
+    if (this->size_ == this->glyphs_.size()) {
+      this->dropped_++;
+      if ((this->drop_policy_ == HT16K33_STREAM_DROP_NEWEST) || this->glyphs_.empty()) {
+        this->rejected_ = true;
+        return;
+      }
+      this->pop_front(1);
+    }
+    this->glyphs_[(this->head_ + this->size_) % this->glyphs_.size()] = glyph;
+    this->size_++;
+    this->rejected_ = false;
+  }
+
+  // The last glyph added. If it was dropped, a scratch glyph stands in, so that special characters that attach to it
+  // are dropped with it.
+  HT16k33Glyph &back() {
+    if (this->rejected_ || (this->size_ == 0)) {
+      return this->scratch_;
+    }
+    return this->glyphs_[(this->head_ + this->size_ - 1) % this->glyphs_.size()];
+  }
+
+  void pop_front(size_t count) {
+    count = std::min(count, this->size_);
+    this->head_ = (this->head_ + count) % this->glyphs_.size();
+    this->size_ -= count;
+  }
+
+  void clear() {
+    this->head_ = 0;
+    this->size_ = 0;
+  }
+
+  uint32_t dropped() const { return this->dropped_; }
+
+ protected:
+  std::vector<HT16k33Glyph> glyphs_;
+  size_t head_{0};  // The index in glyphs_ of the first glyph.
+  size_t size_{0};  // The number of glyphs in the ring.
+  uint8_t drop_policy_{HT16K33_STREAM_DROP_NEWEST};
+  bool rejected_{false};    // True if the last glyph was dropped by the DROP_NEWEST policy.
+  HT16k33Glyph scratch_{};  // Returned by back() when there is no last glyph.
+  uint32_t dropped_{0};     // The number of glyphs dropped because the ring was full.
+};
+
+// The state of one HT16K33 chip in the display chain.
+struct HT16k33Display {
+  explicit HT16k33Display(i2c::I2CDevice *device) : device(device) {}
+
+  i2c::I2CDevice *device;
+  uint8_t ram[HT16K33_FRAME_SIZE]{};          // A copy of the last frame written to the display RAM of this chip.
+  bool ram_valid{false};                      // False if the contents of the display RAM are unknown.
+  uint8_t frame[HT16K33_FRAME_SIZE]{};        // The newest rendered frame for this chip.
+  bool frame_pending{false};                  // True if frame has not been completely sent to the chip yet.
+  bool keyscan{false};                        // True if the keys of this chip are scanned.
+  uint8_t keys[HT16K33_KEY_DATA_SIZE]{};      // The debounced key state.
+  uint8_t key_scan[HT16K33_KEY_DATA_SIZE]{};  // The key state of the last scan.
+  uint8_t key_scan_count{0};                  // The number of scans in a row that returned key_scan.
+  // The last values written to the control registers of this chip, or 0 if unknown. These registers can't be read
+  // back, so the copies are used to skip writes that would not change anything.
+  uint8_t system_setup{0};
+  uint8_t display_setup{0};
+  uint8_t dimming{0};
+  uint8_t row_int{0};
+  uint8_t channel{HT16K33_NO_CHANNEL};  // The multiplexer channel that the chip is on.
+  uint8_t bus{0};                       // The index of the I2C bus that the chip is on. 0 is the primary bus.
+  uint8_t colon{0};                     // The colon bits of the rendered frame. frame has them cleared while the
+                                        // blinking colon is off.
+};
+
+// One step of a transition. The keyframes of a transition are computed once when the message changes, and loop()
+// only has to apply each one when it is due.
+struct HT16k33Keyframe {
+  uint32_t time;                      // The time from the start of the transition, in ms.
+  uint8_t type;                       // One of the HT16K33_KEYFRAME_* types.
+  uint8_t chip;                       // For FRAME keyframes, the index of the chip in displays_.
+  uint8_t value;                      // For DIMMING and BLINK keyframes, the new dimming or blink rate.
+  uint8_t frame[HT16K33_FRAME_SIZE];  // For FRAME keyframes, the frame to send.
+};
+
+// A point of the auto brightness curve. The brightness between two points is interpolated linearly.
+struct HT16k33BrightnessPoint {
+  float value;       // The reading of the sensor.
+  float brightness;  // The brightness at this reading, from 1 to 16.
+};
+
+// Counters that measure the cost of updating the displays. These are totals since boot.
+struct HT16k33Stats {
+  uint32_t frames;                // The number of times update_display() ran.
+  uint32_t bytes_written;         // Bytes written to the displays, including the first byte (command) of each write.
+  uint32_t transactions;          // The number of I2C writes to the displays.
+  uint32_t write_errors;          // The number of I2C writes to the displays that failed.
+  uint32_t update_time_us;        // The total time spent in update_display().
+  uint32_t max_update_time_us;    // The longest time spent in a single call to update_display().
+  uint32_t max_loop_time_us;      // The longest time spent in a single call to loop().
+  uint32_t writer_calls;          // The number of times the writer lambda ran.
+  uint32_t writer_time_us;        // The total time spent in the writer lambda.
+  uint32_t max_writer_time_us;    // The longest time spent in a single call to the writer lambda.
+  uint32_t scroll_steps;          // The number of times the message scrolled by one character.
+  uint32_t scroll_jitter_ms;      // The total time that scroll steps ran after they were due.
+  uint32_t max_scroll_jitter_ms;  // The longest time that a scroll step ran after it was due.
+  uint32_t skipped_frames;        // The number of times update_display() found the displays already up to date.
+  uint32_t stream_dropped;        // The number of characters dropped because the stream was full.
+};
+
 // We can have up to 7 chips. Chip addresses are 0b1110xxx. Default is 0b1110000 (0x70).
 // For 7 segment displays the 28 pin package could address up to 8 digits.
 // So an absolute maximum number of chars is 8*7=56.
+// Behind a TCA9548A multiplexer, each of its 8 channels can have its own set of chips, so the addresses can be used
+// again on every channel.
 
 // defines a type `ht16k33_char_writer_t` that is a pointer to a function of the type defined.
 using ht16k33_char_writer_t = std::function<void(HT16k33CharComponent &)>;
 
+// One message of the playlist. The entry keeps the compiled message, and the rendered frames if it does not scroll,
+// while other entries are shown. When it is shown again and its message did not change, these are used as they are.
+struct HT16k33PlaylistEntry {
+  optional<ht16k33_char_writer_t> writer;  // The lambda that prints the message. If not set, text is shown.
+  std::string text;
+  uint32_t dwell{0};                       // How long the entry is shown, in ms.
+  bool scroll{false};                      // True if the message of this entry scrolls.
+  uint8_t refresh{HT16K33_REFRESH_ONCE};   // When the lambda runs, one of the HT16K33_REFRESH_* policies.
+  bool shown{false};                       // True after the entry was shown once.
+  std::string message;                     // The message that glyphs was compiled from.
+  std::vector<HT16k33Glyph> glyphs;        // The compiled message, while another entry is shown.
+  std::vector<uint8_t> frames;             // The rendered frame of each chip, if the entry does not scroll.
+  bool frames_valid{false};                // True if frames holds the frames for message.
+};
+
+#ifdef USE_BINARY_SENSOR
+// A key in the key matrix of one of the chips.
+class HT16k33Key : public binary_sensor::BinarySensor {
+ public:
+  void set_chip(uint8_t chip) { this->chip_ = chip; }
+  void set_key(uint8_t key) { this->key_ = key; }
+  uint8_t get_chip() const { return this->chip_; }
+  uint8_t get_key() const { return this->key_; }
+
+ protected:
+  uint8_t chip_{0};  // The index of the chip in the display chain. 0 is the primary display.
+  uint8_t key_{0};   // The key number, see HT16K33_KEYS_PER_COMMON.
+};
+#endif
+
 class HT16k33CharComponent : public PollingComponent, public i2c::I2CDevice {
  public:
   void setup() override;
@@ -43,24 +381,106 @@ class HT16k33CharComponent : public PollingComponent, public i2c::I2CDevice {
   void dump_config() override;
 
   void set_writer(ht16k33_char_writer_t &&writer) { this->writer_ = writer; };
+
+  // Playlist. The entries are shown in turn, each for its dwell time. If a playlist is set, the lambda set with
+  // set_writer() is not used.
+  void add_playlist_entry(ht16k33_char_writer_t &&writer, uint32_t dwell, bool scroll, uint8_t refresh) {
+    this->playlist_.emplace_back();
+    this->playlist_.back().writer = writer;
+    this->playlist_.back().dwell = dwell;
+    this->playlist_.back().scroll = scroll;
+    this->playlist_.back().refresh = refresh;
+  }
+  void add_playlist_entry(const char *text, uint32_t dwell, bool scroll) {
+    this->playlist_.emplace_back();
+    this->playlist_.back().text = text;
+    this->playlist_.back().dwell = dwell;
+    this->playlist_.back().scroll = scroll;
+  }
+  void show_entry(size_t index);
+  void next_entry() { this->show_entry(this->playlist_index_ + 1); }
+  size_t get_entry_index() const { return this->playlist_index_; }
+
+  // Streaming ticker. If the stream length is set, the displays show the text added with stream_push() instead of the
+  // message. The text scrolls through the displays at the scroll speed, and the characters that scrolled off are
+  // removed from the stream. stream_push() returns false if any characters were dropped, and stream_free() tells how
+  // many characters still fit, so that a producer can hold back instead.
+  void set_stream_length(uint16_t length) { this->stream_length_ = length; }
+  void set_stream_drop_policy(uint8_t drop_policy) { this->stream_drop_policy_ = drop_policy; }
+  bool stream_push(const char *text);
+  size_t stream_free() const { return this->stream_.capacity() - this->stream_.size(); }
+  void stream_clear();
   float get_setup_priority() const override;
-  uint8_t update_display();
+  uint16_t update_display();
 
-  void add_char(const char *char_to_add, uint16_t char_code);
-  void remove_char(const char *char_to_remove) { this->char_map_.erase(char_to_remove); };
+  // Set the font table. This is generated by display.py and shared between all displays that use the same font.
+  void set_font(const uint16_t *font) { this->font_ = font; }
 
   void set_brightness(uint8_t brightness) { this->brightness_ = brightness - 1; };
-  void set_buffer_max_size(uint16_t size_to_set) { this->char_buffer_max_size_ = size_to_set; };
+  void set_buffer_max_size(uint16_t size_to_set) {
+    this->char_buffer_max_size_ = size_to_set;
+    this->message_buffer_.reserve(size_to_set + 1);  // printf() writes its null terminator after the text
+    this->glyphs_.reserve(size_to_set);
+    this->compiled_message_.reserve(size_to_set);
+  };
 
   // Called automatically during setup to generate a list of I2CDevices that represent the displays.
   // We iterate through the displays_ to address individual displays during runtime.
-  void add_secondary_display(i2c::I2CDevice *display) { this->displays_.push_back(display); }
+  // A display can be on a channel of the multiplexer, and on another I2C bus than the primary display. Each bus has
+  // its own flush queue. display.py numbers the buses, starting with 0 for the bus of the primary display.
+  void add_secondary_display(i2c::I2CDevice *display, uint8_t channel = HT16K33_NO_CHANNEL, uint8_t bus = 0) {
+    this->displays_.emplace_back(display);
+    this->displays_.back().channel = channel;
+    this->displays_.back().bus = bus;
+  }
+
+  // The address of a TCA9548A I2C multiplexer on the bus of the primary display. The channel of a display is only
+  // selected when it is accessed, and the chips are accessed grouped by channel.
+  void set_multiplexer_address(uint8_t address) { this->multiplexer_address_ = address; }
+
+  // Limit the number of bytes sent to and read from the displays on each bus in each call to loop(). This counts all
+  // traffic of the displays: frames, control registers, key scans and the multiplexer. What does not fit is sent in
+  // the following calls. 0 means no limit.
+  void set_max_bytes_per_loop(uint16_t max_bytes) { this->max_bytes_per_loop_ = max_bytes; }
+
+  // Keyscan. The keys are scanned every key_scan_interval ms, and a key has to read the same for key_debounce scans in
+  // a row before it changes state. If the INT pin of the chips is connected, the chips are only read while it is
+  // active, and loop() sleeps until it goes active and wakes it up.
+  void set_interrupt_pin(InternalGPIOPin *pin) { this->interrupt_pin_ = pin; }
+  void set_key_scan_interval(uint32_t interval) { this->key_scan_interval_ = interval; }
+  void set_key_debounce(uint8_t count) { this->key_debounce_ = count; }
+#ifdef USE_BINARY_SENSOR
+  void register_key(HT16k33Key *key) { this->keys_.push_back(key); }
+#endif
+  // The callback is called with the chip index and key number when a key is pressed. This enables keyscan on all chips.
+  void add_on_key_callback(std::function<void(uint8_t, uint8_t)> &&callback) {
+    this->key_callback_.add(std::move(callback));
+  }
+  bool is_key_pressed(uint8_t chip, uint8_t key) const;
 
   void set_scroll(bool scroll) { this->scroll_ = scroll; }
   void set_continuous(bool continuous) { this->continuous_ = continuous; }
   void set_scroll_speed(uint32_t scroll_speed) { this->scroll_speed_ = scroll_speed; }
   void set_scroll_dwell(uint32_t scroll_dwell) { this->scroll_dwell_ = scroll_dwell; }
   void set_scroll_delay(uint32_t scroll_delay) { this->scroll_delay_ = scroll_delay; }
+  // If set, scroll steps that were missed because loop() stalled are shown one per loop until the scrolling is back on
+  // time. Otherwise they are skipped.
+  void set_scroll_catch_up(bool catch_up) { this->scroll_catch_up_ = catch_up; }
+
+  // The transition shown when the message changes, one of the HT16K33_TRANSITION_* types, and its length in ms.
+  void set_transition(uint8_t transition) { this->transition_ = transition; }
+  void set_transition_duration(uint32_t duration) { this->transition_duration_ = duration; }
+
+#ifdef USE_TIME
+  // Clock. The time is printed with the strftime format at the start of each period of the system clock, 1 s or 1 min,
+  // so the displays change exactly when the time does. If the colon blinks, it is turned off for the second half of
+  // each second by sending only the byte of the display RAM that holds it.
+  void set_clock(time::RealTimeClock *clock) { this->clock_ = clock; }
+  void set_clock_format(const char *format) { this->clock_format_ = format; }
+  void set_clock_period(uint32_t period) { this->clock_period_ = period; }
+  void set_clock_leading_zero(bool leading_zero) { this->clock_leading_zero_ = leading_zero; }
+  void set_clock_blink_colon(bool blink_colon) { this->clock_blink_colon_ = blink_colon; }
+#endif
 
   void brightness(uint8_t brightness_to_set);
   void set_blink(uint8_t blink_state);
@@ -68,53 +488,219 @@ class HT16k33CharComponent : public PollingComponent, public i2c::I2CDevice {
   void display_standby(bool standby);
 
   // Evaluate the printf-format and print the result at the given position.
-  uint8_t printf(uint16_t start_pos, bool clear_buffer, const char *format, ...) __attribute__((format(printf, 4, 5)));
+  uint16_t printf(uint16_t start_pos, bool clear_buffer, const char *format, ...) __attribute__((format(printf, 4, 5)));
 
   // Print `str` at the given position.
-  uint8_t print(uint16_t start_pos, bool clear_buffer, const char *str);
+  uint16_t print(uint16_t start_pos, bool clear_buffer, const char *str);
+
+  // Print the first `len` bytes of `str` at the given position.
+  uint16_t print(uint16_t start_pos, bool clear_buffer, const char *str, size_t len);
+
+  // Print `str` at the given position without scanning it for its length.
+  uint16_t print(uint16_t start_pos, bool clear_buffer, std::string_view str);
 
   // Print `str` at position 0.
-  uint8_t print(bool clear_buffer, const char *str);
+  uint16_t print(bool clear_buffer, const char *str);
 
   // Evaluate the strftime-format and print the result at the given position.
-  uint8_t strftime(uint16_t start_pos, bool clear_buffer, const char *format, ESPTime time)
+  uint16_t strftime(uint16_t start_pos, bool clear_buffer, const char *format, ESPTime time)
       __attribute__((format(strftime, 4, 0)));
 
-  uint8_t clock_display(uint16_t start_pos, bool clear_buffer, bool show_leading_zero, bool use_ampm, ESPTime time);
+  uint16_t clock_display(uint16_t start_pos, bool clear_buffer, bool show_leading_zero, bool use_ampm, ESPTime time);
 
   void blank();
 
   /// Evaluate the strftime-format and print the result at position 0.
-  uint8_t strftime(const char *format, ESPTime time) __attribute__((format(strftime, 2, 0)));
+  uint16_t strftime(const char *format, ESPTime time) __attribute__((format(strftime, 2, 0)));
+
+  // Counters that measure the cost of updating the displays.
+  const HT16k33Stats &get_stats() const { return this->stats_; }
+
+#ifdef USE_SENSOR
+  // Optional sensors that report the counters in stats_. They are published at the update interval.
+  SUB_SENSOR(frames)
+  SUB_SENSOR(bytes_written)
+  SUB_SENSOR(transactions)
+  SUB_SENSOR(write_errors)
+  SUB_SENSOR(update_time)
+  SUB_SENSOR(max_update_time)
+  SUB_SENSOR(writer_time)
+  SUB_SENSOR(max_writer_time)
+  SUB_SENSOR(scroll_rate)
+  SUB_SENSOR(scroll_jitter)
+  SUB_SENSOR(skip_ratio)
+  SUB_SENSOR(stream_dropped)
+
+  // Set the brightness from the readings of a sensor, such as an ambient light sensor. The readings are mapped to a
+  // brightness through the curve. The brightness only follows a reading once it is more than the hysteresis (in
+  // brightness steps) past the middle between two steps, so a reading that wobbles does not make the display
+  // flicker. It then moves one step at a time, at most once per step interval.
+  void set_auto_brightness_sensor(sensor::Sensor *sensor) { this->auto_brightness_sensor_ = sensor; }
+  void add_auto_brightness_point(float value, float brightness) {
+    this->auto_brightness_curve_.push_back(HT16k33BrightnessPoint{value, brightness});
+  }
+  void set_auto_brightness_hysteresis(float hysteresis) { this->auto_brightness_hysteresis_ = hysteresis; }
+  void set_auto_brightness_step_interval(uint32_t interval) { this->auto_brightness_step_interval_ = interval; }
+#endif
 
  protected:
-  std::unordered_map<std::string, uint16_t> char_map_ = {{" ", 0b0000000000000000}};
-
-  // These two functions are overridden by device specific versions in the subclasses.
-  virtual uint8_t handle_special_char(char char_to_find, uint8_t position) { return 0; };
-  virtual void write_to_buffer(uint16_t char_to_write, uint8_t char_position){};
-
-  uint8_t get_next_char_(uint16_t start_position, std::string *next_char);
-  void clear_buffer_();
-  uint8_t char_len_(char char_to_test);
-  uint16_t send_to_display_common_(i2c::I2CDevice *display, uint16_t position);
+  const uint16_t *font_{nullptr};
+
+  HT16k33Layout layout_{};
+
+  // Renders the frame of one display into buffer_. HT16k33CharDevice compiles it for the layout of the device.
+  virtual uint16_t render_frame_(uint16_t position) = 0;
+  void set_layout_(const HT16k33Layout &layout);
+
+  bool find_char_code_(uint32_t codepoint, uint16_t *char_code);
+  uint8_t decode_char_(const char *str, size_t length, uint32_t *codepoint);
+  void clear_buffer_() { std::fill(std::begin(this->buffer_), std::end(this->buffer_), 0); }
+  size_t begin_write_(uint16_t start_pos, bool clear_buffer, size_t *room);
+  uint16_t end_write_(uint16_t start_pos, size_t text_start, size_t len, size_t room);
+  void restart_scroll_();
+  void compile_message_();
+  template<typename T> void compile_text_(const char *str, size_t length, T &glyphs);
+  inline const HT16k33Glyph *get_glyph_(uint16_t position);
+  uint8_t find_special_char_(char special_char) const;
+  void write_digit_(uint16_t char_code, uint8_t digit);
+  uint16_t send_to_display_common_(HT16k33Display &display, uint16_t position);
+  void start_transition_();
+  void add_frame_keyframe_(uint32_t time, uint8_t chip, const uint8_t *frame);
+  void add_register_keyframe_(uint32_t time, uint8_t type, uint8_t value);
+  void run_transition_();
+  bool transition_running_() const { return this->next_keyframe_ < this->keyframes_.size(); }
+  bool displays_ram_valid_() const;
+  void refresh_display_();
+  void run_writer_(ht16k33_char_writer_t &writer);
+  void show_entry_(size_t index);
+  void run_playlist_();
+  void update_scroll_();
+  void update_stream_();
+  void schedule_loop_();
+  void advance_scroll_time_(uint32_t now, uint32_t period, uint32_t steps);
+  void queue_frame_(HT16k33Display &display);
+  void show_colon_(bool visible);
+#ifdef USE_TIME
+  void clock_tick_();
+#endif
+#ifdef USE_SENSOR
+  float auto_brightness_curve_at_(float value) const;
+  void auto_brightness_reading_(float value);
+  void auto_brightness_step_();
+#endif
+  void reset_budgets_();
+  bool charge_(const HT16k33Display &display, uint16_t bytes);
+  void flush_displays_();
+  bool flush_bus_(uint8_t bus);
+  uint8_t flush_display_(HT16k33Display &display);
+  i2c::ErrorCode write_display_(HT16k33Display &display, const uint8_t *data, size_t len);
+  i2c::ErrorCode select_channel_(const HT16k33Display &display);
+  // The multiplexer is on the bus of the primary display, and only switches the chips that are on a channel.
+  bool behind_multiplexer_(const HT16k33Display &display) const {
+    return (this->multiplexer_address_ != 0) && (display.channel != HT16K33_NO_CHANNEL) && (display.bus == 0);
+  }
+  void release_channel_();
+  i2c::ErrorCode set_mux_channels_(uint8_t channels);
+  void log_stats_();
+  void publish_stats_();
+  void setup_keyscan_();
+  static void key_isr_(HT16k33CharComponent *component);
+  void commit_registers_();
+  bool commit_register_(HT16k33Display &display, uint8_t *shadow, uint8_t value);
+  void scan_keys_();
+  bool scan_keys_of_(HT16k33Display &display, uint8_t chip, bool check_chip);
 
   uint8_t scroll_state_;
-  uint8_t num_chars_per_display_{0};  // The number of characters per display. This should be set by the derived class.
+  uint8_t num_chars_per_display_{0};  // The number of characters per display. This is set by set_layout_().
 
-  std::vector<i2c::I2CDevice *> displays_{this};
+  std::vector<HT16k33Display> displays_{HT16k33Display(this)};
 
-  uint8_t fist_char_location_;
+  uint16_t fist_char_location_;  // The glyph position of the first character on the display.
 
   bool scroll_{false};
   bool continuous_{false};
   uint32_t scroll_speed_{250};
   uint32_t scroll_dwell_{2000};
   uint32_t scroll_delay_{750};
-  uint32_t last_scroll_{0};
+  bool scroll_catch_up_{false};
+  uint32_t last_scroll_{0};  // The time the last scroll step was due.
 
   uint8_t brightness_{15};  // Brightness of the display from 0 (off) to 15 (brightest)
 
+  // The requested state of the control registers. brightness(), set_blink(), display_off() and display_standby() only
+  // change these. commit_registers_() writes them to the chips, once per loop().
+  bool standby_{false};
+  bool display_on_{true};
+  uint8_t blink_{0};
+  uint8_t dimming_{0x0F};
+  bool registers_changed_{true};
+
+  uint8_t transition_{HT16K33_TRANSITION_NONE};
+  uint32_t transition_duration_{500};
+  std::vector<HT16k33Keyframe> keyframes_;         // The keyframes of the last transition, sorted by time.
+  size_t next_keyframe_{0};                        // The next keyframe to apply.
+  uint32_t transition_start_{0};                   // The time the transition started.
+  uint8_t dimming_override_{HT16K33_NO_OVERRIDE};  // Used instead of dimming_ while a transition runs.
+  uint8_t blink_override_{HT16K33_NO_OVERRIDE};    // Used instead of blink_ while a transition runs.
+  uint16_t segment_mask_{0xFFFF};                  // The segments of each character that render_frame_() draws.
+
+  uint8_t colon_index_{0};    // The byte of the frame that holds the colon between digits 2 and 3.
+  uint8_t colon_bits_{0};     // The bits of the colon, or 0 if the device has none.
+  bool colon_visible_{true};  // False while the blinking colon is off.
+
+#ifdef USE_TIME
+  time::RealTimeClock *clock_{nullptr};
+  std::string clock_format_{"%H:%M"};
+  uint32_t clock_period_{60000};  // The time between clock updates in ms. This divides a minute.
+  bool clock_leading_zero_{true};
+  bool clock_blink_colon_{false};
+#endif
+
+#ifdef USE_SENSOR
+  sensor::Sensor *auto_brightness_sensor_{nullptr};
+  std::vector<HT16k33BrightnessPoint> auto_brightness_curve_;  // Sorted by value.
+  float auto_brightness_hysteresis_{0.25f};
+  uint32_t auto_brightness_step_interval_{250};
+  uint8_t auto_brightness_level_{0};       // The brightness that was set last, or 0 before the first reading.
+  uint8_t auto_brightness_target_{0};      // The brightness of the last reading that passed the hysteresis.
+  uint32_t auto_brightness_last_step_{0};  // The time of the last brightness step, in ms.
+#endif
+
+  // The most bytes loop() may send to and read from each bus per call, or 0 for no limit.
+  uint16_t max_bytes_per_loop_{0};
+  std::vector<uint16_t> bus_budgets_;   // For each bus, the bytes that are left in this call to loop().
+  std::vector<uint8_t> flush_cursors_;  // For each bus, the position in its part of bus_order_ to start flushing at.
+
+  uint8_t multiplexer_address_{0};  // The address of the I2C multiplexer, or 0 if there is none.
+  uint8_t mux_channels_{0};         // The channels that are selected on the multiplexer, as a bit mask.
+  bool mux_channels_valid_{false};  // False if it is not known which channels are selected.
+  std::vector<uint8_t> bus_order_;  // The indexes of the displays, grouped by bus, then by multiplexer channel.
+  std::vector<uint8_t> bus_start_;  // The position in bus_order_ of the first display of each bus, and the end.
+
+  bool keyscan_{false};  // True if the keys of any chip are scanned.
+  InternalGPIOPin *interrupt_pin_{nullptr};
+  volatile bool key_interrupt_{false};  // Set by the INT pin interrupt. Cleared when the key scan starts.
+  bool keys_settling_{true};            // False once no key is pressed or debouncing, so only the INT pin wakes loop().
+  uint32_t key_scan_interval_{20};
+  uint32_t last_key_scan_{0};
+  bool key_scan_running_{false};      // True if a key scan ran out of byte budget before it scanned every chip.
+  uint8_t key_scan_cursor_{0};        // The position in bus_order_ of the next chip to scan.
+  bool key_scan_check_chips_{false};  // False if the key scan that is running knows that no keys are pressed.
+  uint8_t key_debounce_{2};
+#ifdef USE_BINARY_SENSOR
+  std::vector<HT16k33Key *> keys_;
+#endif
+  CallbackManager<void(uint8_t, uint8_t)> key_callback_;
+
+  std::vector<HT16k33Glyph> glyphs_;  // The compiled message. This is rebuilt from message_buffer_ when it changes.
+  bool message_changed_{true};        // Set when message_buffer_ changes.
+  std::string compiled_message_;      // The message that glyphs_ was compiled from.
+
+  // What update_display() rendered last. If the message and the first character are the same, it has nothing to do.
+  bool rendered_{false};           // False if the displays have to be rendered again, whatever the message.
+  uint16_t rendered_location_{0};  // fist_char_location_ at the time.
+  uint16_t rendered_end_{0};       // The glyph position that update_display() returned.
+
   std::string message_buffer_;  // This buffer holds the entire character message to display.
   uint8_t buffer_[20];          // This buffer is used to send the raw bytes to the HT16k33 device.
   uint16_t
@@ -125,7 +711,190 @@ class HT16k33CharComponent : public PollingComponent, public i2c::I2CDevice {
                               //  characters. This means that if multi-byte characters are used, the number of displayed
                               //  characters will be less than the number defined here.
 
+  HT16k33Stats stats_{};
+  HT16k33Stats last_logged_stats_{};     // The counters at the time of the last log_stats_() call.
+  HT16k33Stats last_published_stats_{};  // The counters at the time of the last publish_stats_() call.
+  uint32_t last_published_time_{0};      // The time of the last publish_stats_() call, in ms.
+
   optional<ht16k33_char_writer_t> writer_{};
+
+  uint16_t stream_length_{0};  // The number of characters the stream can hold, or 0 if streaming is off.
+  uint8_t stream_drop_policy_{HT16K33_STREAM_DROP_NEWEST};
+  HT16k33GlyphRing stream_;
+
+  std::vector<HT16k33PlaylistEntry> playlist_;
+  size_t playlist_index_{0};          // The entry that is shown.
+  bool playlist_shown_{false};        // False until the first entry is shown.
+  uint32_t playlist_entry_start_{0};  // The time the entry was due to be shown, in ms.
+};
+
+/***********************************
+ *Get the glyph at a position in the message. In continuous mode, positions past the end of the message wrap around
+ * to the start. In streaming mode, the position is counted from the front of the stream.
+ *
+ *  position: The glyph position in the message.
+ *
+ * Returns: The glyph, or nullptr if the position is past the end of the message.
+ ************************************/
+const HT16k33Glyph *HT16k33CharComponent::get_glyph_(uint16_t position) {
+  if (this->stream_length_ != 0) {
+    // In streaming mode, the displays show the front of the stream.
+    return (position < this->stream_.size()) ? &this->stream_[position] : nullptr;
+  }
+  if (position < this->glyphs_.size()) {
+    return &this->glyphs_[position];
+  }
+  if (this->continuous_ && !this->glyphs_.empty()) {
+    return &this->glyphs_[position % this->glyphs_.size()];
+  }
+  return nullptr;
+}
+
+// A display device. Layout is a struct generated by display.py, with the layout table of the device as its
+// constexpr TABLE. The table is unpacked at compile time, and render_frame_() is compiled for it: The number of
+// digits, where they are, and how their segments are written are all constants, so the loops unroll and the code for
+// the other kinds of layouts is left out.
+template<typename Layout> class HT16k33CharDevice : public HT16k33CharComponent {
+ public:
+  static constexpr HT16k33Layout LAYOUT = unpack_layout(Layout::TABLE);
+  static_assert(LAYOUT.num_digits <= HT16K33_MAX_DIGITS, "too many digits in the layout");
+  static_assert(LAYOUT.num_special_chars <= HT16K33_MAX_SPECIAL_CHARS, "too many special characters in the layout");
+
+  HT16k33CharDevice() { this->set_layout_(LAYOUT); }
+
+ protected:
+  uint16_t render_frame_(uint16_t position) override;
+};
+
+/***********************************
+ *Render the frame of one display into buffer_. How the character code of each digit is written depends on the layout:
+ *  -Direct layouts, such as the Adafruit displays, write each character code as it is.
+ *  -Bit sliced layouts, such as the Sparkfun displays, collect the character codes of all digits, and then gather
+ *   their bits into two words, with one byte for each pair of segments. Each byte of the frame is then written once,
+ *   instead of once for each lit segment of each digit.
+ *  -Other layouts light the segments of each digit one by one.
+ *
+ * Special characters that are only valid at certain locations on the display are shown if they are at a valid
+ * location. A special character in an invalid location is shown as a blank digit. Only one special character is
+ * evaluated per location on the display, so a second special character in a row is a blank digit too. Layouts without
+ * such characters, such as the Adafruit 14 segment displays, have no glyphs with special set, and skip the checks.
+ * Only the segments in segment_mask_ are drawn. This is used to build up the characters in a transition.
+ *
+ *  position: The position in the message of the first glyph to show.
+ *
+ * Returns: The position of the first glyph that is not shown, which is the start of the next display.
+ ************************************/
+template<typename Layout> uint16_t HT16k33CharDevice<Layout>::render_frame_(uint16_t position) {
+  constexpr const HT16k33Layout &l = LAYOUT;
+  uint16_t char_codes[HT16K33_MAX_DIGITS] = {};
+  uint16_t char_code;
+  uint8_t digit_number;
+  bool special_character_found;
+  const HT16k33Glyph *glyph;
+
+  // Adds a character code to a digit. Bit sliced layouts collect the character codes of all digits first.
+  auto write_char_code = [this, &char_codes](uint16_t code, uint8_t digit) {
+    code &= this->segment_mask_ & LAYOUT.segment_mask;
+    if constexpr (LAYOUT.direct) {
+      this->buffer_[LAYOUT.digit_index[digit]] |= code & 0xFF;
+      this->buffer_[LAYOUT.digit_index[digit] + 1] |= code >> 8;
+    } else if constexpr (LAYOUT.bit_sliced) {
+      char_codes[digit] |= code;
+    } else {
+      this->write_digit_(code, digit);
+    }
+  };
+
+  // Writes the special character of a glyph, if it is valid at the position, which is the number of the digit after
+  // it. These are the POSITIONAL special characters, and any special character that follows one of them in the
+  // message. The latter light the digit next to them like when the message is compiled, see compile_text_().
+  auto write_special_char = [this, &write_char_code](uint8_t special, uint8_t position) {
+    switch (LAYOUT.special_types[special - 1]) {
+      case SPECIAL_CHAR_ATTACH_PREVIOUS:
+        // Before the first digit, there is no digit to attach to, and the character is skipped.
+        if (position > 0) {
+          write_char_code(LAYOUT.special_bits[special - 1], position - 1);
+        }
+        return true;
+      case SPECIAL_CHAR_ATTACH_NEXT:
+        if (position >= LAYOUT.num_digits) {
+          return false;
+        }
+        write_char_code(LAYOUT.special_bits[special - 1], position);
+        return true;
+    }
+    uint8_t index = LAYOUT.special_index[special - 1][position];
+    if (index == 0) {
+      return false;
+    }
+    this->buffer_[index] |= LAYOUT.special_mask[special - 1][position];
+    return true;
+  };
+
+  // Clear any old data from the buffer.
+  this->clear_buffer_();
+  this->buffer_[0] = HT16K33_DISPLAY_DATA_ADDRESS;
+
+  digit_number = 0;
+  special_character_found = false;
+
+  while (digit_number < l.num_digits) {
+    glyph = this->get_glyph_(position);
+    if (glyph == nullptr) {
+      // The digits past the end of the message stay blank.
+      digit_number++;
+      continue;
+    }
+
+    position++;
+    if constexpr (l.positional_specials) {
+      if ((glyph->special != 0) && !special_character_found && write_special_char(glyph->special, digit_number)) {
+        special_character_found = true;
+        continue;
+      }
+    }
+
+    write_char_code(glyph->char_code, digit_number);
+    special_character_found = false;
+    digit_number++;
+  }
+
+  if constexpr (l.bit_sliced) {
+    // Byte n of low_segments is the byte of segments n and n + 8, and byte n of high_segments is the byte of segments
+    // n + 4 and n + 12.
+    uint32_t low_segments = 0;
+    uint32_t high_segments = 0;
+    for (uint8_t digit = 0; digit < l.num_digits; digit++) {
+      char_code = char_codes[digit];
+      low_segments |= (HT16K33_NIBBLE_SPREAD[char_code & 0x0F] | (HT16K33_NIBBLE_SPREAD[(char_code >> 8) & 0x0F] << 4))
+                      << l.digit_shift[digit];
+      high_segments |= (HT16K33_NIBBLE_SPREAD[(char_code >> 4) & 0x0F] | (HT16K33_NIBBLE_SPREAD[char_code >> 12] << 4))
+                       << l.digit_shift[digit];
+    }
+    for (uint8_t segment = 0; segment < 4; segment++) {
+      this->buffer_[l.digit_index[0] + (l.segments[segment] >> 3)] |= low_segments >> (segment * 8);
+      this->buffer_[l.digit_index[0] + (l.segments[segment + 4] >> 3)] |= high_segments >> (segment * 8);
+    }
+  }
+
+  // We may be able to have special characters after the last digit, Handle that here.
+  if constexpr (l.positional_specials) {
+    glyph = this->get_glyph_(position);
+    if ((glyph != nullptr) && (glyph->special != 0) && !special_character_found &&
+        write_special_char(glyph->special, digit_number)) {
+      position++;
+    }
+  }
+
+  return position;
+}
+
+// Triggered when a key is pressed, with the chip index and key number.
+class HT16k33KeyTrigger : public Trigger<uint8_t, uint8_t> {
+ public:
+  explicit HT16k33KeyTrigger(HT16k33CharComponent *parent) {
+    parent->add_on_key_callback([this](uint8_t chip, uint8_t key) { this->trigger(chip, key); });
+  }
 };
 
 }  // namespace ht16k33_char
@@ -1,82 +0,0 @@
-#pragma once
-#include "ht16k33_char.h"
-
-namespace esphome {
-namespace ht16k33_char {
-
-class Sparkfun14Seg : public HT16k33CharComponent {
- public:
-  Sparkfun14Seg() {
-    this->num_chars_per_display_ = 4;
-    this->char_map_.insert({
-        {" ", 0b0000000000000000}, {"!", 0b0000000000000110}, {"\"", 0b0000010000100000}, {"#", 0b0010010101001110},
-        {"$", 0b0010010101101101}, {"%", 0b0100100000100100}, {"&", 0b0001011001011101},  {"\'", 0b0000100000000000},
-        {"(", 0b0001100000000000}, {")", 0b0100001000000000}, {"*", 0b0111111101000000},  {"+", 0b0010010101000000},
-        {",", 0b0100000000000000}, {"-", 0b0000000101000000}, {"/", 0b0100100000000000},  {"0", 0b0100100000111111},
-        {"1", 0b0000000000000110}, {"2", 0b0000000101011011}, {"3", 0b0000000100001111},  {"4", 0b0000000101100110},
-        {"5", 0b0001000001101001}, {"6", 0b0000000101111101}, {"7", 0b0010100000000001},  {"8", 0b0000000101111111},
-        {"9", 0b0000000101101111}, {":", 0b0010010000000000}, {";", 0b0100010000000000},  {"<", 0b0001100000000000},
-        {"=", 0b0000000101001000}, {">", 0b0100001000000000}, {"?", 0b0010000100000011},  {"@", 0b0000010100111011},
-        {"A", 0b0000000101110111}, {"B", 0b0010010100001111}, {"C", 0b0000000000111001},  {"D", 0b0010010000001111},
-        {"E", 0b0000000101111001}, {"F", 0b0000000001110001}, {"G", 0b0000000100111101},  {"H", 0b0000000101110110},
-        {"I", 0b0010010000000000}, {"J", 0b0000000000011110}, {"K", 0b0001100001110000},  {"L", 0b0000000000111000},
-        {"M", 0b0000101000110110}, {"N", 0b0001001000110110}, {"O", 0b0000000000111111},  {"P", 0b0000000101110011},
-        {"Q", 0b0001000000111111}, {"R", 0b0001000101110011}, {"S", 0b0000000101101101},  {"T", 0b0010010000000001},
-        {"U", 0b0000000000111110}, {"V", 0b0100100000110000}, {"W", 0b0101000000110110},  {"X", 0b0101101000000000},
-        {"Y", 0b0010101000000000}, {"Z", 0b0100100000001001}, {"[", 0b0000000000111001},  {"\\", 0b0001001000000000},
-        {"]", 0b0000000000001111}, {"^", 0b0000000000100011}, {"_", 0b0000000000001000},  {"`", 0b0000001000000000},
-        {"a", 0b0010000001011000}, {"b", 0b0001000001111000}, {"c", 0b0000000101011000},  {"d", 0b0100000100001110},
-        {"e", 0b0100000001011000}, {"f", 0b0000000001110001}, {"g", 0b0000001100001111},  {"h", 0b0010000001110000},
-        {"i", 0b0010000000000000}, {"j", 0b0000000000001110}, {"k", 0b0011110000000000},  {"l", 0b0000000000110000},
-        {"m", 0b0010000101010100}, {"n", 0b0010000001010000}, {"o", 0b0000000101011100},  {"p", 0b0000100001110001},
-        {"q", 0b0001000101100011}, {"r", 0b0000000001010000}, {"s", 0b0001000100001000},  {"t", 0b0000000001111000},
-        {"u", 0b0000000000011100}, {"v", 0b0001000000000100}, {"w", 0b0101000000010100},  {"x", 0b0101000101000000},
-        {"y", 0b0000010100001110}, {"z", 0b0100000001001000}, {"{", 0b0100001001001001},  {"|", 0b0010010000000000},
-        {"}", 0b0001100100001001}, {"~", 0b0000000101000000},
-    });
-  }
-
- protected:
-  uint8_t handle_special_char(char char_to_find, uint8_t position) override;
-  void write_to_buffer(uint16_t char_to_write, uint8_t char_position) override;
-};
-
-class Sparkfun14SegFlip : public HT16k33CharComponent {
- public:
-  Sparkfun14SegFlip() {
-    this->num_chars_per_display_ = 4;
-    this->char_map_.insert({
-        {" ", 0b0000000000000000}, {"!", 0b0000000000110000}, {"\"", 0b0010000000000100}, {"#", 0b0010010101110001},
-        {"$", 0b0010010101101101}, {"%", 0b0100100000100100}, {"&", 0b0011001100101011},  {"\'", 0b0100000000000000},
-        {"(", 0b0100001000000000}, {")", 0b0001100000000000}, {"*", 0b0111111101000000},  {"+", 0b0010010101000000},
-        {",", 0b0000100000000000}, {"-", 0b0000000101000000}, {"/", 0b0100100000000000},  {"0", 0b0100100000111111},
-        {"1", 0b0000000000110000}, {"2", 0b0000000101011011}, {"3", 0b0000000001111001},  {"4", 0b0000000101110100},
-        {"5", 0b0000001100001101}, {"6", 0b0000000101101111}, {"7", 0b0100010000001000},  {"8", 0b0000000101111111},
-        {"9", 0b0000000101111101}, {":", 0b0010010000000000}, {";", 0b0010100000000000},  {"<", 0b0100001000000000},
-        {"=", 0b0000000101000001}, {">", 0b0001100000000000}, {"?", 0b0000010001011000},  {"@", 0b0010000001011111},
-        {"A", 0b0000000101111110}, {"B", 0b0010010001111001}, {"C", 0b0000000000001111},  {"D", 0b0010010000111001},
-        {"E", 0b0000000101001111}, {"F", 0b0000000100001110}, {"G", 0b0000000001101111},  {"H", 0b0000000101110110},
-        {"I", 0b0010010000000000}, {"J", 0b0000000000110011}, {"K", 0b0100001100000110},  {"L", 0b0000000000000111},
-        {"M", 0b0101000000110110}, {"N", 0b0001001000110110}, {"O", 0b0000000000111111},  {"P", 0b0000000101011110},
-        {"Q", 0b0000001000111111}, {"R", 0b0000001101011110}, {"S", 0b0000000101101101},  {"T", 0b0010010000001000},
-        {"U", 0b0000000000110111}, {"V", 0b0100100000000110}, {"W", 0b0000101000110110},  {"X", 0b0101101000000000},
-        {"Y", 0b0101010000000000}, {"Z", 0b0100100000001001}, {"[", 0b0000000000001111},  {"\\", 0b0001001000000000},
-        {"]", 0b0000000000111001}, {"^", 0b0000000000011100}, {"_", 0b0000000000000001},  {"`", 0b0001000000000000},
-        {"a", 0b0000010100000011}, {"b", 0b0000001100000111}, {"c", 0b0000000101000011},  {"d", 0b0000100001110001},
-        {"e", 0b0000100100000011}, {"f", 0b0000000100001110}, {"g", 0b0001000001111001},  {"h", 0b0000010100000110},
-        {"i", 0b0000010000000000}, {"j", 0b0000000000110001}, {"k", 0b0110011000000000},  {"l", 0b0000000000000110},
-        {"m", 0b0000010101100010}, {"n", 0b0000010100000010}, {"o", 0b0000000101100011},  {"p", 0b0100000100001110},
-        {"q", 0b0000001101011100}, {"r", 0b0000000100000010}, {"s", 0b0000001001000001},  {"t", 0b0000000100000111},
-        {"u", 0b0000000000100011}, {"v", 0b0000001000100000}, {"w", 0b0000101000100010},  {"x", 0b0000101101000000},
-        {"y", 0b0010000001110001}, {"z", 0b0000100100000001}, {"{", 0b0001100100001001},  {"|", 0b0010010000000000},
-        {"}", 0b0100001001001001}, {"~", 0b0000000101000000},
-    });
-  }
-
- protected:
-  uint8_t handle_special_char(char char_to_find, uint8_t position) override;
-  void write_to_buffer(uint16_t char_to_write, uint8_t char_position) override;
-};
-
-}  // namespace ht16k33_char
-}  // namespace esphome
@@ -0,0 +1,41 @@
+// Replaces the global operator new and delete with versions that count the allocations.
+
+#include "alloc_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace host {
+
+static std::atomic<uint64_t> allocation_count{0};  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+uint64_t allocations() { return allocation_count.load(std::memory_order_relaxed); }
+
+static void *allocate(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void *ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+}  // namespace host
+
+void *operator new(size_t size) { return host::allocate(size); }
+void *operator new[](size_t size) { return host::allocate(size); }
+void *operator new(size_t size, const std::nothrow_t & /*tag*/) noexcept {
+  try {
+    return host::allocate(size);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept { return operator new(size, tag); }
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t /*size*/) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t /*size*/) noexcept { std::free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t & /*tag*/) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t & /*tag*/) noexcept { std::free(ptr); }
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+namespace host {
+
+// The number of heap allocations made through operator new since the program started. alloc_counter.cpp replaces the
+// global operator new, so every executable that links it counts its allocations.
+uint64_t allocations();
+
+}  // namespace host
@@ -0,0 +1,305 @@
+// Benchmarks the component on the host, against the HT16K33 emulator. Each scenario runs on every device type for a
+// fixed span of host time, and reports per frame (per call of update_display() that rendered the message):
+//  -ns/frame: the wall time of the run, divided by the frames. This includes the main loop and the emulated bus.
+//  -bytes/frame: the bytes written to the chips, without the address byte of each transaction.
+//  -trans/s: the I2C transactions per second of host time.
+//  -allocs/frame: the heap allocations made during the run.
+//
+// It then times render_frame_() alone, without the main loop and the bus: A message with special characters is
+// rendered from every position, 7 times over. The fastest of the 7 runs is reported in ns per frame.
+//
+// Last, it measures the frame latency of a 6 chip chain on one bus, and split over two buses, on mock buses that
+// each transfer on their own thread. A write returns as soon as the bus has taken it, and only waits while the bus is
+// still busy with the write before it, like a bus driver with a one deep transmit queue. ESPHome I2C writes block
+// until the transfer is done, so on a device, the split chain takes as long as the single bus.
+//
+//   ht16k33_char_bench [--quick] [--render]
+//
+// --quick runs each scenario for a tenth of the time, which is enough to check that the scenarios still run.
+// --render only runs the render_frame_() benchmark.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "esphome/core/hal.h"
+#include "host_display.h"
+
+using esphome::App;
+using esphome::ht16k33_char::HT16k33CharComponent;
+
+namespace {
+
+// render_frame_() is protected. A derived class may take a pointer to it, which is all this class is used for.
+class RenderFrame : public HT16k33CharComponent {
+ public:
+  static uint16_t call(HT16k33CharComponent *component, uint16_t position) {
+    return (component->*(&RenderFrame::render_frame_))(position);
+  }
+};
+
+struct Scenario {
+  const char *name;
+  uint8_t num_chips;
+  uint16_t buffer_size;
+  uint32_t run_ms;
+  std::function<void(HT16k33CharComponent *)> configure;
+};
+
+// A message of `length` characters that every font can show.
+std::string bench_message(size_t length) {
+  static const char CHARS[] = "0123456789 -AbCdEF";
+  std::string message;
+  for (size_t i = 0; i < length; i++) {
+    message += CHARS[i % (sizeof(CHARS) - 1)];
+  }
+  return message;
+}
+
+const Scenario SCENARIOS[] = {
+    // A clock that is printed every second, and changes once a minute.
+    {"static clock", 1, 64, 600000,
+     [](HT16k33CharComponent *display) {
+       display->set_update_interval(1000);
+       display->set_writer([](HT16k33CharComponent &it) {
+         uint32_t minutes = esphome::millis() / 60000;
+         it.printf(0, true, "%02" PRIu32 ":%02" PRIu32, (minutes / 60) % 24, minutes % 60);
+       });
+     }},
+    // A 255 byte message that scrolls without end through 7 chips.
+    {"255 byte continuous scroll, 7 chips", 7, 255, 60000,
+     [](HT16k33CharComponent *display) {
+       std::string message = bench_message(255);
+       display->set_update_interval(1000);
+       display->set_scroll(true);
+       display->set_continuous(true);
+       display->set_writer([message](HT16k33CharComponent &it) { it.print(0, true, message); });
+     }},
+    // A 4 KB message that scrolls without end through 7 chips. A scroll step costs the same as with 255 bytes.
+    {"4 KB continuous scroll, 7 chips", 7, 4096, 60000,
+     [](HT16k33CharComponent *display) {
+       std::string message = bench_message(4096);
+       display->set_update_interval(1000);
+       display->set_scroll(true);
+       display->set_continuous(true);
+       display->set_writer([message](HT16k33CharComponent &it) { it.print(0, true, message); });
+     }},
+    // A 4 KB message with a counter in front, printed every 100 ms, so the whole message is compiled again each time.
+    {"4 KB printf, 7 chips", 7, 4096, 60000,
+     [](HT16k33CharComponent *display) {
+       std::string message = bench_message(4096 - 8);
+       display->set_update_interval(100);
+       display->set_writer([message](HT16k33CharComponent &it) {
+         static uint32_t counter = 0;
+         it.printf(0, true, "%7" PRIu32 " %s", counter++, message.c_str());
+       });
+     }},
+    // A counter that is printed at every pass of the main loop.
+    {"rapid printf", 2, 64, 60000,
+     [](HT16k33CharComponent *display) {
+       display->set_update_interval(16);
+       display->set_writer([](HT16k33CharComponent &it) {
+         static uint32_t counter = 0;
+         it.printf(0, true, "%8" PRIu32, counter++);
+       });
+     }},
+};
+
+void run(const Scenario &scenario, const host::DeviceType &type, uint32_t run_ms) {
+  host::HostDisplay display(type, scenario.num_chips, scenario.buffer_size);
+  scenario.configure(display.component.get());
+  display.setup(0);
+
+  display.bus.reset_counters();
+  uint32_t frames_before = display->get_stats().frames;
+  uint64_t allocations_before = host::allocations();
+  auto start = std::chrono::steady_clock::now();
+
+  App.run_for(run_ms);
+
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  uint64_t allocations = host::allocations() - allocations_before;
+  uint32_t frames = display->get_stats().frames - frames_before;
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  double per_frame = frames > 0 ? 1.0 / frames : 0.0;
+
+  std::printf("  %-30s %8" PRIu32 " %12.0f %12.1f %10.2f %13.2f\n", type.name, frames, ns * per_frame,
+              display.bus.bytes_written() * per_frame, display.bus.transactions() * 1000.0 / run_ms,
+              allocations * per_frame);
+}
+
+void run_render(const host::DeviceType &type, uint32_t frames) {
+  static const char MESSAGE[] = "12:34 5.6.7.8 HELLO WORLD 3.14159 26:53 58.97 93:23 84.62 64.33 83.27 95.02 88.41 "
+                                "97:16 93.99";
+  host::HostDisplay display(type, 1, 256);
+  display->set_continuous(true);
+  display->set_writer([](HT16k33CharComponent &it) { it.print(0, true, MESSAGE); });
+  display.setup();
+
+  uint16_t positions = sizeof(MESSAGE) - 1;
+  volatile uint16_t next_position;  // Keeps the calls from being left out.
+  double best = 0.0;
+  for (int run = 0; run < 7; run++) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frames; frame++) {
+      next_position = RenderFrame::call(display.component.get(), frame % positions);
+    }
+    (void) next_position;
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+    best = (run == 0) ? ns : std::min(best, ns);
+  }
+  std::printf("  %-30s %12.1f\n", type.name, best);
+}
+
+// The time to transfer one byte at 100 kHz, with its ACK bit.
+const std::chrono::microseconds BYTE_TIME(90);
+
+/***********************************
+ *A bus that transfers each write on its own thread. Every address answers. The threads hand over the writes through
+ * an atomic byte count, and poll it while they wait.
+ ************************************/
+class ThreadedBus : public esphome::i2c::I2CBus {
+ public:
+  ThreadedBus() : thread_([this]() { this->run_(); }) {}
+  ~ThreadedBus() override {
+    this->stop_ = true;
+    this->thread_.join();
+  }
+
+  esphome::i2c::ErrorCode write(uint8_t /*address*/, const uint8_t * /*buffer*/, size_t len,
+                                bool /*stop*/) override {
+    this->wait_idle();
+    // The address byte is sent too.
+    this->pending_bytes_ = len + 1;
+    return esphome::i2c::ERROR_OK;
+  }
+  using esphome::i2c::I2CBus::write;
+
+  esphome::i2c::ErrorCode read(uint8_t /*address*/, uint8_t *buffer, size_t len) override {
+    this->wait_idle();
+    std::this_thread::sleep_for(BYTE_TIME * (len + 1));
+    std::fill(buffer, buffer + len, 0);
+    return esphome::i2c::ERROR_OK;
+  }
+
+  // Waits until the bus finished its last transfer.
+  void wait_idle() {
+    while (this->pending_bytes_ != 0) {
+      std::this_thread::sleep_for(POLL_TIME);
+    }
+  }
+
+ protected:
+  static constexpr std::chrono::microseconds POLL_TIME{5};
+
+  void run_() {
+    while (!this->stop_) {
+      size_t bytes = this->pending_bytes_;
+      if (bytes == 0) {
+        std::this_thread::sleep_for(POLL_TIME);
+        continue;
+      }
+      std::this_thread::sleep_for(BYTE_TIME * bytes);
+      this->pending_bytes_ = 0;
+    }
+  }
+
+  std::atomic<size_t> pending_bytes_{0};
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+// The fastest frame latency of a 6 chip chain, from the start of the loop() that sends a new message to all chips
+// until the buses are done. If the chain is split, the last 3 chips are on a second bus.
+std::chrono::microseconds run_split(bool split) {
+  static const char *const MESSAGES[] = {"888888888888888888888888", "111111111111111111111111"};
+  ThreadedBus buses[2];
+  auto wait_idle = [&buses]() {
+    for (auto &bus : buses) {
+      bus.wait_idle();
+    }
+  };
+
+  App.reset();
+  const host::DeviceType &type = host::DEVICE_TYPES[0];
+  std::unique_ptr<HT16k33CharComponent> component(type.create());
+  std::vector<std::unique_ptr<esphome::i2c::I2CDevice>> secondary;
+  component->set_font(type.font);
+  component->set_buffer_max_size(64);
+  component->set_i2c_bus(&buses[0]);
+  component->set_i2c_address(0x70);
+  for (uint8_t chip = 1; chip < 6; chip++) {
+    uint8_t bus = (split && (chip >= 3)) ? 1 : 0;
+    auto device = std::make_unique<esphome::i2c::I2CDevice>();
+    device->set_i2c_bus(&buses[bus]);
+    device->set_i2c_address(0x70 + chip);
+    component->add_secondary_display(device.get(), esphome::ht16k33_char::HT16K33_NO_CHANNEL, bus);
+    secondary.push_back(std::move(device));
+  }
+  App.register_component(component.get());
+  App.setup();
+  App.run_for(100);
+  wait_idle();
+
+  // The fastest of a few frames is the least disturbed by the scheduler of the host.
+  std::chrono::microseconds best = std::chrono::microseconds::max();
+  for (int frame = 0; frame < 10; frame++) {
+    component->print(0, true, MESSAGES[frame % 2]);
+    component->update_display();
+    auto start = std::chrono::steady_clock::now();
+    App.loop_once();
+    wait_idle();
+    auto latency = std::chrono::steady_clock::now() - start;
+    best = std::min(best, std::chrono::duration_cast<std::chrono::microseconds>(latency));
+  }
+  App.reset();
+  return best;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  bool quick = false;
+  bool render_only = false;
+  for (int arg = 1; arg < argc; arg++) {
+    quick = quick || (std::strcmp(argv[arg], "--quick") == 0);
+    render_only = render_only || (std::strcmp(argv[arg], "--render") == 0);
+  }
+
+  for (const auto &scenario : SCENARIOS) {
+    if (render_only) {
+      continue;
+    }
+    uint32_t run_ms = quick ? scenario.run_ms / 10 : scenario.run_ms;
+    std::printf("%s (%" PRIu32 " s)\n", scenario.name, run_ms / 1000);
+    std::printf("  %-30s %8s %12s %12s %10s %13s\n", "device", "frames", "ns/frame", "bytes/frame", "trans/s",
+                "allocs/frame");
+    for (const auto &type : host::DEVICE_TYPES) {
+      run(scenario, type, run_ms);
+    }
+    std::printf("\n");
+  }
+
+  uint32_t frames = quick ? 200000 : 2000000;
+  std::printf("render_frame_() alone (7 x %" PRIu32 " frames)\n", frames);
+  std::printf("  %-30s %12s\n", "device", "ns/frame");
+  for (const auto &type : host::DEVICE_TYPES) {
+    run_render(type, frames);
+  }
+
+  if (!render_only) {
+    std::printf("\n6 chip frame latency on threaded buses, %s\n", host::DEVICE_TYPES[0].name);
+    std::printf("  %-30s %12lld us\n", "one bus", static_cast<long long>(run_split(false).count()));
+    std::printf("  %-30s %12lld us\n", "split over two buses", static_cast<long long>(run_split(true).count()));
+  }
+  return 0;
+}
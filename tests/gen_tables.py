@@ -0,0 +1,101 @@
+"""Generates the layout structs and font tables of all device types for the host tests.
+
+display.py is imported with the ESPHome modules mocked, so the tests use the same tables
+that the component is built with on the device.
+"""
+
+import importlib.util
+from pathlib import Path
+import sys
+from unittest.mock import MagicMock
+
+ESPHOME_MODULES = [
+    "esphome",
+    "esphome.automation",
+    "esphome.codegen",
+    "esphome.components",
+    "esphome.components.binary_sensor",
+    "esphome.components.display",
+    "esphome.components.i2c",
+    "esphome.components.sensor",
+    "esphome.components.time",
+    "esphome.config_validation",
+    "esphome.const",
+    "esphome.core",
+    "esphome.final_validate",
+    "esphome.pins",
+]
+
+
+def load_display_py(path):
+    for module in ESPHOME_MODULES:
+        sys.modules[module] = MagicMock()
+    spec = importlib.util.spec_from_file_location("ht16k33_char_display", path)
+    display = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(display)
+    return display
+
+
+def words(table):
+    return ", ".join(f"0x{word:04X}" for word in table)
+
+
+def main():
+    display_py, output = sys.argv[1], sys.argv[2]
+    display = load_display_py(display_py)
+
+    lines = [
+        "#pragma once",
+        "",
+        "// Generated by gen_tables.py from display.py. Do not edit.",
+        "",
+        '#include "ht16k33_char.h"',
+        "",
+    ]
+    layouts = {}
+    registry = []
+    for index, (name, device) in enumerate(display.HT16K33_DEVICE_TYPES.items()):
+        table = tuple(display.layout_to_table(device["LAYOUT"]))
+        if table not in layouts:
+            layouts[table] = f"ht16k33_char_layout_{len(layouts)}"
+            lines.append(f"struct {layouts[table]} {{")
+            lines.append(f"  static constexpr uint16_t TABLE[] = {{{words(table)}}};")
+            lines.append("};")
+        font = {
+            char: device["FORMAT_FUNCTION"](code)
+            for char, code in device["FONT"].items()
+        }
+        lines.append(
+            f"static const uint16_t ht16k33_char_font_{index}[] = "
+            f"{{{words(display.font_to_table(font))}}};"
+        )
+        registry.append((name, index, layouts[table]))
+
+    lines += [
+        "",
+        "namespace host {",
+        "",
+        "struct DeviceType {",
+        "  const char *name;",
+        "  const uint16_t *font;",
+        "  esphome::ht16k33_char::HT16k33CharComponent *(*create)();",
+        "};",
+        "",
+        "static const DeviceType DEVICE_TYPES[] = {",
+    ]
+    for name, index, layout in registry:
+        lines.append(
+            f'    {{"{name}", ht16k33_char_font_{index}, []() -> esphome::ht16k33_char::HT16k33CharComponent * '
+            f"{{ return new esphome::ht16k33_char::HT16k33CharDevice<{layout}>(); }}}},"
+        )
+    lines += [
+        "};",
+        "",
+        "}  // namespace host",
+        "",
+    ]
+    Path(output).write_text("\n".join(lines))
+
+
+if __name__ == "__main__":
+    main()
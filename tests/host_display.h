@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "esphome/core/application.h"
+#include "ht16k33_char_tables.h"
+#include "ht16k33_emulator.h"
+
+namespace host {
+
+// The name of a device type, with the characters that a test name cannot have replaced by '_'.
+inline std::string test_name(const DeviceType &type) {
+  std::string name = type.name;
+  std::replace_if(
+      name.begin(), name.end(), [](char c) { return !isalnum(static_cast<unsigned char>(c)); }, '_');
+  return name;
+}
+
+// The number of device types in DEVICE_TYPES.
+static const size_t NUM_DEVICE_TYPES = sizeof(DEVICE_TYPES) / sizeof(DEVICE_TYPES[0]);
+
+// The address of the emulated TCA9548A multiplexer.
+static const uint8_t MULTIPLEXER_ADDRESS = 0x77;
+
+/***********************************
+ *A display chain on an emulated bus: the component, set up like display.py would, and one emulated chip for each
+ * display. Chips are at 0x70, 0x71, ... in chain order. If the chain is multiplexed, the secondary chips are all at
+ * 0x71 instead, each on its own channel of a multiplexer, starting with channel 0.
+ ************************************/
+class HostDisplay {
+ public:
+  HostDisplay(const DeviceType &type, uint8_t num_chips, uint16_t buffer_size = 64, bool multiplexed = false) {
+    esphome::App.reset();
+    this->component.reset(type.create());
+    this->component->set_font(type.font);
+    this->component->set_buffer_max_size(buffer_size);
+    this->component->set_i2c_bus(&this->bus);
+    this->component->set_i2c_address(0x70);
+    this->chips.push_back(this->bus.add_chip(0x70));
+    if (multiplexed) {
+      this->component->set_multiplexer_address(MULTIPLEXER_ADDRESS);
+      this->bus.set_multiplexer_address(MULTIPLEXER_ADDRESS);
+    }
+    for (uint8_t chip = 1; chip < num_chips; chip++) {
+      uint8_t address = multiplexed ? 0x71 : 0x70 + chip;
+      uint8_t channel = multiplexed ? chip - 1 : EmulatedBus::NO_CHANNEL;
+      auto device = std::make_unique<esphome::i2c::I2CDevice>();
+      device->set_i2c_bus(&this->bus);
+      device->set_i2c_address(address);
+      this->component->add_secondary_display(device.get(), channel);
+      this->secondary.push_back(std::move(device));
+      this->chips.push_back(this->bus.add_chip(address, channel));
+    }
+    esphome::App.register_component(this->component.get());
+  }
+
+  ~HostDisplay() { esphome::App.reset(); }
+
+  esphome::ht16k33_char::HT16k33CharComponent *operator->() { return this->component.get(); }
+
+  // Runs setup(), then the main loop until the displays are written.
+  void setup(uint32_t settle_ms = 100) {
+    esphome::App.setup();
+    esphome::App.run_for(settle_ms);
+  }
+
+  // The display RAM of all chips, in chain order.
+  std::vector<uint8_t> ram() const {
+    std::vector<uint8_t> ram;
+    for (auto *chip : this->chips) {
+      ram.insert(ram.end(), chip->ram(), chip->ram() + HT16k33Emulator::RAM_SIZE);
+    }
+    return ram;
+  }
+
+  EmulatedBus bus;
+  std::unique_ptr<esphome::ht16k33_char::HT16k33CharComponent> component;
+  std::vector<std::unique_ptr<esphome::i2c::I2CDevice>> secondary;
+  std::vector<HT16k33Emulator *> chips;
+};
+
+}  // namespace host
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "esphome/components/i2c/i2c.h"
+
+namespace host {
+
+/***********************************
+ *A model of the HT16K33 as seen from the I2C bus:
+ *  -16 bytes of display RAM. A write of command 0x00-0x0F sets the address pointer, the data bytes that follow are
+ *   written from there, and the pointer wraps from 0x0F to 0x00.
+ *  -System setup (0x20), display setup and blink (0x80), ROW/INT set (0xA0) and dimming (0xE0).
+ *  -6 bytes of key RAM at 0x40, and the INT flag at 0x60. A read returns the bytes from the address pointer on, with
+ *   auto-increment. A key press sets the INT flag until the key RAM is read, and it stays set while a key is held.
+ * The chip only runs its display and key scan while the oscillator is on, like the real one.
+ ************************************/
+class HT16k33Emulator {
+ public:
+  static const uint8_t RAM_SIZE = 16;
+  static const uint8_t KEY_RAM_SIZE = 6;
+
+  explicit HT16k33Emulator(uint8_t address) : address_(address) {}
+
+  uint8_t address() const { return this->address_; }
+
+  // A write transaction. The first byte is the command.
+  void write(const uint8_t *data, size_t len) {
+    if (len == 0) {
+      return;
+    }
+    uint8_t command = data[0];
+    switch (command & 0xF0) {
+      case 0x00:
+        this->pointer_ = command & 0x0F;
+        for (size_t i = 1; i < len; i++) {
+          this->ram_[this->pointer_] = data[i];
+          this->pointer_ = (this->pointer_ + 1) & 0x0F;
+        }
+        this->ram_writes_++;
+        this->ram_bytes_ += len - 1;
+        break;
+      case 0x20:
+        this->oscillator_ = (command & 0x01) != 0;
+        this->system_setup_writes_++;
+        break;
+      case 0x40:
+        this->pointer_ = 0x40 | (command & 0x0F);
+        break;
+      case 0x60:
+        this->pointer_ = 0x60;
+        break;
+      case 0x80:
+        this->display_on_ = (command & 0x01) != 0;
+        this->blink_ = (command >> 1) & 0x03;
+        this->display_setup_writes_++;
+        break;
+      case 0xA0:
+        this->row_int_ = command & 0x03;
+        this->row_int_writes_++;
+        break;
+      case 0xE0:
+        this->dimming_ = command & 0x0F;
+        this->dimming_writes_++;
+        break;
+      default:
+        break;
+    }
+  }
+
+  // A read transaction, from the address pointer set by the last command.
+  void read(uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      if (this->pointer_ < RAM_SIZE) {
+        data[i] = this->ram_[this->pointer_];
+        this->pointer_ = (this->pointer_ + 1) & 0x0F;
+      } else if (this->pointer_ == 0x60) {
+        data[i] = this->int_flag() ? 0xFF : 0x00;
+      } else {
+        uint8_t offset = this->pointer_ - 0x40;
+        data[i] = (offset < KEY_RAM_SIZE) ? this->key_ram_[offset] : 0x00;
+        this->pointer_++;
+        if (offset + 1 >= KEY_RAM_SIZE) {
+          this->int_flag_ = false;
+        }
+      }
+    }
+  }
+
+  // Press or release a key, numbered as in the component: (common * 13) + (K - 1).
+  void set_key(uint8_t key, bool pressed) {
+    uint8_t common = key / 13;
+    uint8_t k = key % 13;
+    uint8_t &byte = this->key_ram_[common * 2 + k / 8];
+    uint8_t bit = 1 << (k % 8);
+    byte = pressed ? (byte | bit) : (byte & ~bit);
+    if (pressed && this->oscillator_) {
+      this->int_flag_ = true;
+    }
+  }
+
+  // The INT flag is set by a key press, and by every key scan of the chip while a key is held.
+  bool int_flag() const {
+    if (!this->oscillator_) {
+      return false;
+    }
+    bool held = false;
+    for (uint8_t byte : this->key_ram_) {
+      held |= (byte != 0);
+    }
+    return this->int_flag_ || held;
+  }
+
+  // The INT pin is active low while the INT flag is set and ROW15/INT is the INT output.
+  bool int_pin_active() const { return ((this->row_int_ & 0x01) != 0) && this->int_flag(); }
+
+  const uint8_t *ram() const { return this->ram_; }
+  bool oscillator() const { return this->oscillator_; }
+  bool display_on() const { return this->display_on_; }
+  uint8_t blink() const { return this->blink_; }
+  uint8_t dimming() const { return this->dimming_; }
+  uint8_t row_int() const { return this->row_int_; }
+
+  uint32_t ram_writes() const { return this->ram_writes_; }
+  uint32_t ram_bytes() const { return this->ram_bytes_; }
+  uint32_t system_setup_writes() const { return this->system_setup_writes_; }
+  uint32_t display_setup_writes() const { return this->display_setup_writes_; }
+  uint32_t dimming_writes() const { return this->dimming_writes_; }
+  uint32_t row_int_writes() const { return this->row_int_writes_; }
+
+ protected:
+  uint8_t address_;
+  uint8_t ram_[RAM_SIZE]{};
+  uint8_t key_ram_[KEY_RAM_SIZE]{};
+  uint8_t pointer_{0};
+  bool int_flag_{false};
+  bool oscillator_{false};
+  bool display_on_{false};
+  uint8_t blink_{0};
+  uint8_t dimming_{0x0F};
+  uint8_t row_int_{0};
+
+  uint32_t ram_writes_{0};
+  uint32_t ram_bytes_{0};
+  uint32_t system_setup_writes_{0};
+  uint32_t display_setup_writes_{0};
+  uint32_t dimming_writes_{0};
+  uint32_t row_int_writes_{0};
+};
+
+// One transaction on the bus, as recorded by EmulatedBus.
+struct Transaction {
+  uint8_t address;
+  bool read;
+  std::vector<uint8_t> data;
+};
+
+/***********************************
+ *An I2C bus with HT16K33 chips, and optionally a TCA9548A multiplexer. A chip is either on the bus itself, or on a
+ * channel of the multiplexer, where it only answers while the channel is selected. If two chips answer the same
+ * address, a read fails the way a real bus would. The bus counts the bytes and transactions, without the address byte
+ * of each transaction, and can record every transaction.
+ ************************************/
+class EmulatedBus : public esphome::i2c::I2CBus {
+ public:
+  static const uint8_t NO_CHANNEL = 0xFF;
+
+  HT16k33Emulator *add_chip(uint8_t address, uint8_t channel = NO_CHANNEL) {
+    this->chips_.push_back(Chip{std::make_unique<HT16k33Emulator>(address), channel});
+    return this->chips_.back().chip.get();
+  }
+  void set_multiplexer_address(uint8_t address) { this->mux_address_ = address; }
+  uint8_t mux_channels() const { return this->mux_channels_; }
+
+  esphome::i2c::ErrorCode write(uint8_t address, const uint8_t *buffer, size_t len, bool /*stop*/) override {
+    this->count_(address, false, buffer, len);
+    if ((this->mux_address_ != 0) && (address == this->mux_address_)) {
+      if (len > 0) {
+        this->mux_channels_ = buffer[len - 1];
+      }
+      this->mux_writes_++;
+      return esphome::i2c::ERROR_OK;
+    }
+    bool found = false;
+    for (auto &chip : this->chips_) {
+      if (this->answers_(chip, address)) {
+        chip.chip->write(buffer, len);
+        found = true;
+      }
+    }
+    return found ? esphome::i2c::ERROR_OK : esphome::i2c::ERROR_NOT_ACKNOWLEDGED;
+  }
+  using esphome::i2c::I2CBus::write;
+
+  esphome::i2c::ErrorCode read(uint8_t address, uint8_t *buffer, size_t len) override {
+    HT16k33Emulator *found = nullptr;
+    for (auto &chip : this->chips_) {
+      if (this->answers_(chip, address)) {
+        if (found != nullptr) {
+          this->collisions_++;
+          return esphome::i2c::ERROR_UNKNOWN;
+        }
+        found = chip.chip.get();
+      }
+    }
+    if (found == nullptr) {
+      return esphome::i2c::ERROR_NOT_ACKNOWLEDGED;
+    }
+    found->read(buffer, len);
+    this->count_(address, true, buffer, len);
+    return esphome::i2c::ERROR_OK;
+  }
+
+  void set_recording(bool recording) { this->recording_ = recording; }
+  const std::vector<Transaction> &log() const { return this->log_; }
+
+  void reset_counters() {
+    this->bytes_written_ = 0;
+    this->bytes_read_ = 0;
+    this->writes_ = 0;
+    this->reads_ = 0;
+    this->mux_writes_ = 0;
+    this->log_.clear();
+  }
+  uint32_t bytes_written() const { return this->bytes_written_; }
+  uint32_t bytes_read() const { return this->bytes_read_; }
+  uint32_t writes() const { return this->writes_; }
+  uint32_t reads() const { return this->reads_; }
+  uint32_t transactions() const { return this->writes_ + this->reads_; }
+  uint32_t bytes() const { return this->bytes_written_ + this->bytes_read_; }
+  uint32_t mux_writes() const { return this->mux_writes_; }
+  uint32_t collisions() const { return this->collisions_; }
+
+ protected:
+  struct Chip {
+    std::unique_ptr<HT16k33Emulator> chip;
+    uint8_t channel;
+  };
+
+  bool answers_(const Chip &chip, uint8_t address) const {
+    if (chip.chip->address() != address) {
+      return false;
+    }
+    return (chip.channel == NO_CHANNEL) || ((this->mux_channels_ & (1 << chip.channel)) != 0);
+  }
+
+  void count_(uint8_t address, bool read, const uint8_t *buffer, size_t len) {
+    if (read) {
+      this->reads_++;
+      this->bytes_read_ += len;
+    } else {
+      this->writes_++;
+      this->bytes_written_ += len;
+    }
+    if (this->recording_) {
+      this->log_.push_back(Transaction{address, read, std::vector<uint8_t>(buffer, buffer + len)});
+    }
+  }
+
+  std::vector<Chip> chips_;
+  uint8_t mux_address_{0};
+  uint8_t mux_channels_{0};
+  bool recording_{false};
+  std::vector<Transaction> log_;
+  uint32_t bytes_written_{0};
+  uint32_t bytes_read_{0};
+  uint32_t writes_{0};
+  uint32_t reads_{0};
+  uint32_t mux_writes_{0};
+  uint32_t collisions_{0};
+};
+
+}  // namespace host
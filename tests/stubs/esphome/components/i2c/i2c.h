@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace i2c {
+
+enum ErrorCode {
+  NO_ERROR = 0,
+  ERROR_OK = 0,
+  ERROR_INVALID_ARGUMENT = 1,
+  ERROR_NOT_ACKNOWLEDGED = 2,
+  ERROR_TIMEOUT = 3,
+  ERROR_NOT_INITIALIZED = 4,
+  ERROR_TOO_LARGE = 5,
+  ERROR_UNKNOWN = 6,
+  ERROR_CRC = 7,
+};
+
+// The bus interface of ESPHome, with one virtual call for each direction. Tests implement it with a model of the
+// chips on the bus.
+class I2CBus {
+ public:
+  virtual ~I2CBus() = default;
+
+  virtual ErrorCode read(uint8_t address, uint8_t *buffer, size_t len) = 0;
+  virtual ErrorCode write(uint8_t address, const uint8_t *buffer, size_t len, bool stop) = 0;
+  ErrorCode write(uint8_t address, const uint8_t *buffer, size_t len) { return this->write(address, buffer, len, true); }
+};
+
+class I2CDevice {
+ public:
+  I2CDevice() = default;
+  virtual ~I2CDevice() = default;
+
+  void set_i2c_address(uint8_t address) { this->address_ = address; }
+  void set_i2c_bus(I2CBus *bus) { this->bus_ = bus; }
+  uint8_t get_i2c_address() const { return this->address_; }
+
+  ErrorCode read(uint8_t *data, size_t len) { return this->bus_->read(this->address_, data, len); }
+  ErrorCode write(const uint8_t *data, size_t len, bool stop = true) {
+    return this->bus_->write(this->address_, data, len, stop);
+  }
+
+  ErrorCode read_register(uint8_t a_register, uint8_t *data, size_t len, bool stop = true) {
+    ErrorCode err = this->write(&a_register, 1, stop);
+    if (err != ERROR_OK) {
+      return err;
+    }
+    return this->read(data, len);
+  }
+
+ protected:
+  uint8_t address_{0x00};
+  I2CBus *bus_{nullptr};
+};
+
+}  // namespace i2c
+}  // namespace esphome
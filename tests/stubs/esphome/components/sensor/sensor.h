@@ -0,0 +1,41 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <utility>
+
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace sensor {
+
+class Sensor {
+ public:
+  void publish_state(float state) {
+    this->state = state;
+    this->has_state_ = true;
+    this->callback_.call(state);
+  }
+  void add_on_state_callback(std::function<void(float)> &&callback) { this->callback_.add(std::move(callback)); }
+  bool has_state() const { return this->has_state_; }
+  float get_state() const { return this->state; }
+
+  float state{0.0f};
+
+ protected:
+  bool has_state_{false};
+  CallbackManager<void(float)> callback_;
+};
+
+}  // namespace sensor
+}  // namespace esphome
+
+#define LOG_SENSOR(prefix, type, obj) ((void) (obj))
+
+#define SUB_SENSOR(name) \
+ protected: \
+  sensor::Sensor *name##_sensor_{nullptr}; \
+\
+ public: \
+  void set_##name##_sensor(sensor::Sensor *sensor) { this->name##_sensor_ = sensor; }
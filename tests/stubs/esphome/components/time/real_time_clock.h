@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ctime>
+#include <functional>
+#include <utility>
+
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/time.h"
+
+namespace esphome {
+namespace time {
+
+class RealTimeClock : public PollingComponent {
+ public:
+  void update() override {}
+  ESPTime now() { return ESPTime::from_epoch_local(::time(nullptr)); }
+  void add_on_time_sync_callback(std::function<void()> &&callback) { this->time_sync_callback_.add(std::move(callback)); }
+  void synchronize() { this->time_sync_callback_.call(); }
+
+ protected:
+  CallbackManager<void()> time_sync_callback_;
+};
+
+}  // namespace time
+}  // namespace esphome
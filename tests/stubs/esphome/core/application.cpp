@@ -0,0 +1,135 @@
+#include "esphome/core/application.h"
+
+#include <algorithm>
+
+#include "esphome/core/hal.h"
+
+namespace esphome {
+
+namespace setup_priority {
+const float BUS = 1000.0f;
+const float IO = 900.0f;
+const float HARDWARE = 800.0f;
+const float DATA = 600.0f;
+const float PROCESSOR = 400.0f;
+const float AFTER_CONNECTION = 100.0f;
+}  // namespace setup_priority
+
+Application App;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+static uint64_t host_time_us = 0;
+
+uint32_t millis() { return static_cast<uint32_t>(host_time_us / 1000); }
+uint32_t micros() { return static_cast<uint32_t>(host_time_us); }
+void delay(uint32_t ms) { host_time_us += static_cast<uint64_t>(ms) * 1000; }
+
+void Component::enable_loop_soon_any_context() { this->loop_soon_requested_ = true; }
+
+bool Component::take_loop_soon_request() {
+  if (!this->loop_soon_requested_) {
+    return false;
+  }
+  this->loop_soon_requested_ = false;
+  return true;
+}
+
+void Component::set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f) {
+  App.add_timeout(this, name, timeout, std::move(f));
+}
+
+bool Component::cancel_timeout(const std::string &name) { return App.cancel_timeout(this, name); }
+
+void Application::register_component(Component *component) {
+  this->components_.push_back(component);
+  auto *polling = dynamic_cast<PollingComponent *>(component);
+  if (polling != nullptr) {
+    this->polling_.push_back(Polling{polling, 0});
+  }
+}
+
+void Application::setup() {
+  for (auto *component : this->components_) {
+    this->loop_component_start_time_ = millis();
+    component->setup();
+  }
+  for (auto &polling : this->polling_) {
+    polling.next_us = host_time_us;
+  }
+}
+
+void Application::add_timeout(Component *component, const std::string &name, uint32_t timeout,
+                              std::function<void()> &&f) {
+  this->cancel_timeout(component, name);
+  this->timeouts_.push_back(
+      Timeout{component, name, host_time_us + static_cast<uint64_t>(timeout) * 1000, std::move(f)});
+}
+
+bool Application::cancel_timeout(Component *component, const std::string &name) {
+  auto it = std::find_if(this->timeouts_.begin(), this->timeouts_.end(),
+                         [&](const Timeout &t) { return (t.component == component) && (t.name == name); });
+  if (it == this->timeouts_.end()) {
+    return false;
+  }
+  this->timeouts_.erase(it);
+  return true;
+}
+
+void Application::run_due_() {
+  // Timeouts may add timeouts, so take the due ones out first.
+  while (true) {
+    auto it = std::min_element(this->timeouts_.begin(), this->timeouts_.end(),
+                               [](const Timeout &a, const Timeout &b) { return a.due_us < b.due_us; });
+    if ((it == this->timeouts_.end()) || (it->due_us > host_time_us)) {
+      break;
+    }
+    auto f = std::move(it->f);
+    this->timeouts_.erase(it);
+    this->loop_component_start_time_ = millis();
+    f();
+  }
+  for (auto &polling : this->polling_) {
+    if (polling.next_us <= host_time_us) {
+      polling.next_us += static_cast<uint64_t>(polling.component->get_update_interval()) * 1000;
+      this->loop_component_start_time_ = millis();
+      polling.component->update();
+    }
+  }
+}
+
+void Application::loop_once() {
+  uint64_t start = host_time_us;
+  this->run_due_();
+  for (auto *component : this->components_) {
+    if (component->take_loop_soon_request()) {
+      component->enable_loop();
+    }
+    if (!component->is_loop_enabled()) {
+      continue;
+    }
+    this->loop_component_start_time_ = millis();
+    this->component_loop_calls_++;
+    component->loop();
+  }
+  host_time_us = std::max(host_time_us, start + static_cast<uint64_t>(this->loop_interval_) * 1000);
+}
+
+void Application::run_for(uint32_t ms) {
+  uint64_t end = host_time_us + static_cast<uint64_t>(ms) * 1000;
+  while (host_time_us < end) {
+    this->loop_once();
+  }
+}
+
+void Application::advance(uint32_t ms) { host_time_us += static_cast<uint64_t>(ms) * 1000; }
+void Application::advance_us(uint64_t us) { host_time_us += us; }
+
+void Application::reset() {
+  this->components_.clear();
+  this->polling_.clear();
+  this->timeouts_.clear();
+  this->loop_component_start_time_ = 0;
+  this->component_loop_calls_ = 0;
+  host_time_us = 0;
+}
+
+}  // namespace esphome
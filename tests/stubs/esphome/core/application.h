@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+
+// A simulated ESPHome main loop. The host clock only moves when run_for() or advance() moves it. Each pass of the
+// main loop runs the due timeouts and updates, then calls loop() of every component that has its loop enabled, and
+// takes loop_interval ms, like the default 16 ms loop of ESPHome.
+class Application {
+ public:
+  void register_component(Component *component);
+
+  // Runs setup() of the registered components, in the order they were registered.
+  void setup();
+
+  // Runs the main loop for ms of host time.
+  void run_for(uint32_t ms);
+
+  // Runs one pass of the main loop, then moves the clock to the next pass.
+  void loop_once();
+
+  // Moves the host clock without running anything.
+  void advance(uint32_t ms);
+  void advance_us(uint64_t us);
+
+  uint32_t get_loop_component_start_time() const { return this->loop_component_start_time_; }
+
+  void set_loop_interval(uint32_t ms) { this->loop_interval_ = ms; }
+  uint32_t get_loop_interval() const { return this->loop_interval_; }
+
+  // The number of loop() calls made to components. A component that disables its loop while idle is not called.
+  uint32_t get_component_loop_calls() const { return this->component_loop_calls_; }
+
+  // Forgets all components, timeouts and updates, and sets the clock back to 0.
+  void reset();
+
+  void add_timeout(Component *component, const std::string &name, uint32_t timeout, std::function<void()> &&f);
+  bool cancel_timeout(Component *component, const std::string &name);
+
+ protected:
+  struct Timeout {
+    Component *component;
+    std::string name;
+    uint64_t due_us;
+    std::function<void()> f;
+  };
+  struct Polling {
+    PollingComponent *component;
+    uint64_t next_us;
+  };
+
+  void run_due_();
+
+  std::vector<Component *> components_;
+  std::vector<Polling> polling_;
+  std::vector<Timeout> timeouts_;
+  uint32_t loop_interval_{16};
+  uint32_t loop_component_start_time_{0};
+  uint32_t component_loop_calls_{0};
+};
+
+extern Application App;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+}  // namespace esphome
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <functional>
+
+namespace esphome {
+
+template<typename... Ts> class Trigger {
+ public:
+  void trigger(Ts... x) {
+    if (this->action_) {
+      this->action_(x...);
+    }
+  }
+  void set_action(std::function<void(Ts...)> &&action) { this->action_ = std::move(action); }
+
+ protected:
+  std::function<void(Ts...)> action_;
+};
+
+}  // namespace esphome
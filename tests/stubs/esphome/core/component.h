@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace esphome {
+
+namespace setup_priority {
+extern const float BUS;
+extern const float IO;
+extern const float HARDWARE;
+extern const float DATA;
+extern const float PROCESSOR;
+extern const float AFTER_CONNECTION;
+}  // namespace setup_priority
+
+// The parts of the ESPHome component API that the component uses. The scheduling calls are served by the simulated
+// main loop in application.h.
+class Component {
+ public:
+  virtual ~Component() = default;
+
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return setup_priority::DATA; }
+
+  void mark_failed() { this->failed_ = true; }
+  bool is_failed() const { return this->failed_; }
+
+  // Loop control as in ESPHome 2025.x. enable_loop_soon_any_context() may be called from an ISR or another thread.
+  void enable_loop() { this->loop_enabled_ = true; }
+  void disable_loop() { this->loop_enabled_ = false; }
+  void enable_loop_soon_any_context();
+  bool is_loop_enabled() const { return this->loop_enabled_; }
+
+  void set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f);
+  bool cancel_timeout(const std::string &name);
+
+  // Used by the simulated main loop.
+  bool take_loop_soon_request();
+
+ protected:
+  bool failed_{false};
+  bool loop_enabled_{true};
+  volatile bool loop_soon_requested_{false};
+};
+
+class PollingComponent : public Component {
+ public:
+  PollingComponent() = default;
+  explicit PollingComponent(uint32_t update_interval) : update_interval_(update_interval) {}
+
+  virtual void update() = 0;
+
+  void set_update_interval(uint32_t update_interval) { this->update_interval_ = update_interval; }
+  uint32_t get_update_interval() const { return this->update_interval_; }
+
+ protected:
+  uint32_t update_interval_{1000};
+};
+
+}  // namespace esphome
@@ -0,0 +1,6 @@
+#pragma once
+
+// The host build has every optional part of the component.
+#define USE_BINARY_SENSOR
+#define USE_SENSOR
+#define USE_TIME
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+#define IRAM_ATTR
+
+namespace esphome {
+
+// The host clock. It only moves when the test or benchmark moves it, see host::advance().
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+
+}  // namespace esphome
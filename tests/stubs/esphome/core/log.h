@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdarg>
+
+#include "esphome/core/defines.h"
+
+// Logging is compiled out on the host.
+namespace esphome {
+inline void host_log(const char * /*format*/, ...) {}
+}  // namespace esphome
+
+#define ESP_LOGE(tag, ...) esphome::host_log(__VA_ARGS__)
+#define ESP_LOGW(tag, ...) esphome::host_log(__VA_ARGS__)
+#define ESP_LOGI(tag, ...) esphome::host_log(__VA_ARGS__)
+#define ESP_LOGD(tag, ...) esphome::host_log(__VA_ARGS__)
+#define ESP_LOGV(tag, ...) esphome::host_log(__VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) esphome::host_log(__VA_ARGS__)
+
+#define YESNO(b) ((b) ? "YES" : "NO")
+#define LOG_PIN(prefix, pin) ((void) (pin))
+#define LOG_UPDATE_INTERVAL(this) ((void) (this))
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+namespace esphome {
+
+struct ESPTime {
+  struct tm tm {};
+  time_t timestamp{0};
+
+  size_t strftime(char *buffer, size_t buffer_len, const char *format) { return ::strftime(buffer, buffer_len, format, &this->tm); }
+  bool is_valid() const { return this->timestamp > 0; }
+
+  static ESPTime from_epoch_local(time_t epoch) {
+    ESPTime time;
+    localtime_r(&epoch, &time.tm);
+    time.timestamp = epoch;
+    return time;
+  }
+};
+
+}  // namespace esphome
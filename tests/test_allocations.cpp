@@ -0,0 +1,131 @@
+// Counts the heap allocations of the component once it is set up. Compiling a message, rendering it and scrolling
+// it must not allocate, so that a display can scroll all day without fragmenting the heap.
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "alloc_counter.h"
+#include "host_display.h"
+
+using esphome::App;
+using esphome::ht16k33_char::HT16k33CharComponent;
+
+namespace {
+
+TEST(AllocationCounterTest, CountsAllocations) {
+  uint64_t allocations = host::allocations();
+  // The pointer goes through a volatile, so that the compiler cannot leave out the allocation.
+  int *volatile value = new int(1);
+  delete value;
+  EXPECT_EQ(host::allocations() - allocations, 1u);
+}
+
+class AllocationTest : public ::testing::TestWithParam<size_t> {
+ protected:
+  const host::DeviceType &type() const { return host::DEVICE_TYPES[GetParam()]; }
+};
+
+TEST_P(AllocationTest, CompileAndRenderDoNotAllocate) {
+  host::HostDisplay display(this->type(), 3);
+  display->set_update_interval(50);
+  // Messages of changing length, with a 2 byte UTF-8 character and an invalid lead byte.
+  display->set_writer([](HT16k33CharComponent &it) {
+    static uint32_t counter = 0;
+    counter++;
+    it.printf(0, true, "%*u \xC2\xB0 \xFF-", static_cast<int>(counter % 40), static_cast<unsigned>(counter));
+  });
+  display.setup();
+
+  uint32_t frames = display->get_stats().frames;
+  uint64_t allocations = host::allocations();
+  App.run_for(5000);
+  EXPECT_EQ(host::allocations() - allocations, 0u);
+  EXPECT_GE(display->get_stats().frames - frames, 90u);
+}
+
+TEST_P(AllocationTest, ScrollStepsDoNotAllocate) {
+  host::HostDisplay display(this->type(), 7, 255);
+  std::string message(255, 'A');
+  for (size_t i = 0; i < message.size(); i++) {
+    message[i] = "0123456789 -AbCdEF"[i % 18];
+  }
+  display->set_scroll(true);
+  display->set_continuous(true);
+  display->set_writer([message](HT16k33CharComponent &it) { it.print(0, true, message); });
+  display.setup();
+
+  uint32_t scroll_steps = display->get_stats().scroll_steps;
+  uint64_t allocations = host::allocations();
+  App.run_for(20000);
+  EXPECT_EQ(host::allocations() - allocations, 0u);
+  EXPECT_GE(display->get_stats().scroll_steps - scroll_steps, 50u);
+}
+
+TEST_P(AllocationTest, ShorterAndLongerMessagesDoNotAllocate) {
+  host::HostDisplay display(this->type(), 2, 64);
+  display.setup();
+
+  // The first print of the full buffer size may grow the compiled message once.
+  std::string longest(64, '8');
+  display->print(0, true, longest);
+  display->update();
+
+  uint64_t allocations = host::allocations();
+  for (size_t length = 0; length <= 64; length += 4) {
+    display->print(0, true, std::string_view(longest).substr(0, length));
+    display->update();
+    App.run_for(50);
+  }
+  EXPECT_EQ(host::allocations() - allocations, 0u);
+}
+
+// Runs the playlist until the next time its last entry is shown, and halfway through its dwell time.
+void show_once_entry(host::HostDisplay &display) {
+  while (display->get_entry_index() == 3) {
+    App.loop_once();
+  }
+  while (display->get_entry_index() != 3) {
+    App.loop_once();
+  }
+  App.run_for(50);
+}
+
+TEST_P(AllocationTest, PlaylistSwitchesDoNotAllocate) {
+  host::HostDisplay display(this->type(), 2, 64);
+  uint32_t once_calls = 0;
+  display->add_playlist_entry("HELLO", 100, false);
+  display->add_playlist_entry("0123456789", 100, false);
+  display->add_playlist_entry([](HT16k33CharComponent &it) { it.printf(0, true, "%u", 42u); }, 100, false,
+                              esphome::ht16k33_char::HT16K33_REFRESH_ON_SHOW);
+  display->add_playlist_entry(
+      [&once_calls](HT16k33CharComponent &it) {
+        once_calls++;
+        it.printf(0, true, "%u", 1234u);
+      },
+      100, true, esphome::ht16k33_char::HT16K33_REFRESH_ONCE);
+  display.setup();
+
+  // The first time round, the lambda entries grow to fit their messages.
+  App.run_for(500);
+  show_once_entry(display);
+  std::vector<uint8_t> once_ram = display.ram();
+  uint32_t writer_calls = display->get_stats().writer_calls;
+  uint64_t allocations = host::allocations();
+  App.run_for(2000);
+  EXPECT_EQ(host::allocations() - allocations, 0u);
+  // The ON_SHOW entry runs each time it is shown, once per round of the playlist. The ONCE entry only ran once, and
+  // shows what it printed then.
+  EXPECT_GE(display->get_stats().writer_calls - writer_calls, 4u);
+  EXPECT_EQ(once_calls, 1u);
+  show_once_entry(display);
+  EXPECT_EQ(display.ram(), once_ram);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllDevices, AllocationTest, ::testing::Range<size_t>(0, host::NUM_DEVICE_TYPES),
+                         [](const ::testing::TestParamInfo<size_t> &info) {
+                           return host::test_name(host::DEVICE_TYPES[info.param]);
+                         });
+
+}  // namespace
@@ -0,0 +1,130 @@
+// Checks that max_bytes_per_loop bounds all traffic of the displays in each pass of the main loop: frames, control
+// registers, key scans and the multiplexer.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "host_display.h"
+
+using esphome::App;
+using esphome::ht16k33_char::HT16k33CharComponent;
+
+namespace {
+
+class BudgetTest : public ::testing::TestWithParam<bool> {
+ protected:
+  bool multiplexed() const { return GetParam(); }
+  // The smallest budget display.py allows. With the multiplexer, a full frame also needs the channel select and the
+  // release.
+  uint16_t max_bytes() const { return this->multiplexed() ? 18 : 16; }
+};
+
+TEST_P(BudgetTest, EveryLoopStaysInBudget) {
+  host::HostDisplay display(host::DEVICE_TYPES[0], 7, 255, this->multiplexed());
+  std::string message;
+  for (size_t i = 0; i < 255; i++) {
+    message += "0123456789 -AbCdEF"[i % 18];
+  }
+  std::vector<uint16_t> keys;
+  display->set_max_bytes_per_loop(this->max_bytes());
+  display->set_update_interval(100);
+  display->set_scroll(true);
+  display->set_continuous(true);
+  display->set_scroll_speed(20);
+  display->set_scroll_delay(50);
+  display->add_on_key_callback([&keys](uint8_t chip, uint8_t key) { keys.push_back(chip * 100 + key); });
+  // Every update changes the brightness and the blink rate, so every chip gets register writes too.
+  display->set_writer([message](HT16k33CharComponent &it) {
+    static uint8_t counter = 0;
+    counter++;
+    it.print(0, true, message);
+    it.brightness(1 + counter % 16);
+    it.set_blink(counter % 4);
+  });
+  App.setup();
+
+  uint32_t before = display.bus.bytes();
+  for (int pass = 0; pass < 2000; pass++) {
+    if (pass == 500) {
+      display.chips[3]->set_key(7, true);
+    }
+    App.loop_once();
+    uint32_t bytes = display.bus.bytes() - before;
+    before = display.bus.bytes();
+    ASSERT_LE(bytes, this->max_bytes()) << "pass " << pass;
+    if (this->multiplexed()) {
+      ASSERT_EQ(display.bus.mux_channels(), 0) << "pass " << pass;
+    }
+  }
+
+  EXPECT_EQ(display.bus.collisions(), 0u);
+  EXPECT_GT(display->get_stats().scroll_steps, 100u);
+  ASSERT_EQ(keys.size(), 1u);
+  EXPECT_EQ(keys[0], 307);
+}
+
+TEST_P(BudgetTest, FramesAndRegistersCatchUp) {
+  host::HostDisplay limited(host::DEVICE_TYPES[0], 7, 64, this->multiplexed());
+  limited->set_max_bytes_per_loop(this->max_bytes());
+  limited->set_writer([](HT16k33CharComponent &it) {
+    it.print(0, true, "HELPHELPHELPHELPHELPHELPHELP");
+    it.brightness(5);
+  });
+  limited.setup(500);
+  std::vector<uint8_t> ram = limited.ram();
+  std::vector<uint8_t> dimming;
+  for (auto *chip : limited.chips) {
+    dimming.push_back(chip->dimming());
+  }
+
+  host::HostDisplay unlimited(host::DEVICE_TYPES[0], 7, 64, this->multiplexed());
+  unlimited->set_writer([](HT16k33CharComponent &it) {
+    it.print(0, true, "HELPHELPHELPHELPHELPHELPHELP");
+    it.brightness(5);
+  });
+  unlimited.setup(500);
+
+  EXPECT_EQ(ram, unlimited.ram());
+  for (size_t chip = 0; chip < unlimited.chips.size(); chip++) {
+    EXPECT_EQ(dimming[chip], unlimited.chips[chip]->dimming()) << "chip " << chip;
+    EXPECT_EQ(dimming[chip], 4) << "chip " << chip;
+  }
+}
+
+// The multiplexer is on the bus of the primary display. The chips that are not behind it, here the primary display
+// and a display on another bus, are accessed without switching it.
+TEST(MultiplexerTest, OnlyChipsOnAChannelSwitchIt) {
+  int value = 0;
+  host::HostDisplay display(host::DEVICE_TYPES[0], 3, 64, true);
+  host::EmulatedBus other;
+  esphome::i2c::I2CDevice device;
+  device.set_i2c_bus(&other);
+  device.set_i2c_address(0x70);
+  display->add_secondary_display(&device, esphome::ht16k33_char::HT16K33_NO_CHANNEL, 1);
+  host::HT16k33Emulator *other_chip = other.add_chip(0x70);
+  display->set_update_interval(100);
+  display->set_writer(
+      [&value](HT16k33CharComponent &it) { it.printf(0, true, "%04d%04d%04d%04d", value, value, value, value); });
+  display.setup();
+
+  for (int step = 0; step < 20; step++) {
+    value = (value + 1111) % 10000;
+    display.bus.reset_counters();
+    App.run_for(100);
+    // One select for each of the two channels, and the release.
+    EXPECT_EQ(display.bus.mux_writes(), 3u) << "step " << step;
+    EXPECT_TRUE(std::equal(display.chips[0]->ram(), display.chips[0]->ram() + host::HT16k33Emulator::RAM_SIZE,
+                           other_chip->ram()))
+        << "step " << step;
+  }
+  EXPECT_EQ(display.bus.collisions(), 0u);
+}
+
+INSTANTIATE_TEST_SUITE_P(Buses, BudgetTest, ::testing::Bool(), [](const ::testing::TestParamInfo<bool> &info) {
+  return info.param ? std::string("Multiplexed") : std::string("Direct");
+});
+
+}  // namespace
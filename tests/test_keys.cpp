@@ -0,0 +1,131 @@
+// Scans the key matrix of the emulated chips.
+
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "host_display.h"
+
+using esphome::App;
+using esphome::ht16k33_char::HT16k33CharComponent;
+
+namespace {
+
+// The INT pin of the emulated chips. The ROW15/INT outputs of the chips are wired together, so the pin is low while
+// any chip pulls it low. poll() stands in for the edge detection of the GPIO and runs the interrupt on a falling edge.
+class IntPin : public esphome::InternalGPIOPin {
+ public:
+  explicit IntPin(const std::vector<host::HT16k33Emulator *> &chips) : chips_(chips) {}
+  void setup() override {}
+  bool digital_read() override {
+    for (auto *chip : this->chips_) {
+      if (chip->int_pin_active()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void poll() {
+    bool level = this->digital_read();
+    if (this->level_ && !level && (this->func_ != nullptr)) {
+      this->func_(this->arg_);
+    }
+    this->level_ = level;
+  }
+
+ protected:
+  void attach_interrupt(void (*func)(void *), void *arg, esphome::gpio::InterruptType type) const override {
+    EXPECT_EQ(type, esphome::gpio::INTERRUPT_FALLING_EDGE);
+    this->func_ = func;
+    this->arg_ = arg;
+  }
+
+  std::vector<host::HT16k33Emulator *> chips_;
+  bool level_{true};
+  mutable void (*func_)(void *){nullptr};
+  mutable void *arg_{nullptr};
+};
+
+// Runs the main loop, with the INT pin checked after each pass.
+void run_with_pin(IntPin &pin, uint32_t ms) {
+  for (uint32_t time = 0; time < ms; time += 16) {
+    App.loop_once();
+    pin.poll();
+  }
+}
+
+TEST(KeysTest, PressIsReportedOnceWithChipAndKey) {
+  host::HostDisplay display(host::DEVICE_TYPES[0], 3);
+  std::vector<std::pair<uint8_t, uint8_t>> presses;
+  display->add_on_key_callback([&presses](uint8_t chip, uint8_t key) { presses.emplace_back(chip, key); });
+  display.setup();
+
+  for (auto *chip : display.chips) {
+    EXPECT_EQ(chip->row_int(), 0);
+  }
+
+  display.chips[1]->set_key(20, true);
+  App.run_for(200);
+  display.chips[1]->set_key(20, false);
+  App.run_for(200);
+
+  ASSERT_EQ(presses.size(), 1u);
+  EXPECT_EQ(presses[0].first, 1);
+  EXPECT_EQ(presses[0].second, 20);
+}
+
+TEST(KeysTest, IdleScanOnlyReadsTheIntFlag) {
+  host::HostDisplay display(host::DEVICE_TYPES[0], 3);
+  display->add_on_key_callback([](uint8_t, uint8_t) {});
+  display->set_key_scan_interval(20);
+  display.setup();
+
+  // Each scan writes the INT flag address and reads one byte from each chip.
+  display.bus.reset_counters();
+  App.run_for(1000);
+  uint32_t scans = 1000 / 32;
+  EXPECT_GT(display.bus.reads(), 0u);
+  EXPECT_LE(display.bus.reads(), (scans + 2) * 3);
+  EXPECT_EQ(display.bus.bytes_read(), display.bus.reads());
+  EXPECT_EQ(display.bus.writes(), display.bus.reads());
+}
+
+TEST(KeysTest, IntPinWakesTheLoop) {
+  host::HostDisplay display(host::DEVICE_TYPES[0], 3);
+  IntPin pin(display.chips);
+  std::vector<std::pair<uint8_t, uint8_t>> presses;
+  display->set_update_interval(60000);
+  display->set_interrupt_pin(&pin);
+  display->add_on_key_callback([&presses](uint8_t chip, uint8_t key) { presses.emplace_back(chip, key); });
+  display.setup();
+
+  for (auto *chip : display.chips) {
+    EXPECT_EQ(chip->row_int() & 0x01, 1);
+  }
+
+  // Once the keys settled, loop() sleeps until a key is pressed, and the chips are not read.
+  run_with_pin(pin, 200);
+  uint32_t loop_calls = App.get_component_loop_calls();
+  display.bus.reset_counters();
+  run_with_pin(pin, 2000);
+  EXPECT_EQ(App.get_component_loop_calls() - loop_calls, 0u);
+  EXPECT_EQ(display.bus.transactions(), 0u);
+
+  display.chips[2]->set_key(5, true);
+  run_with_pin(pin, 200);
+  display.chips[2]->set_key(5, false);
+  run_with_pin(pin, 200);
+  ASSERT_EQ(presses.size(), 1u);
+  EXPECT_EQ(presses[0].first, 2);
+  EXPECT_EQ(presses[0].second, 5);
+  EXPECT_FALSE(display->is_key_pressed(2, 5));
+
+  // The release was debounced, so loop() sleeps again.
+  loop_calls = App.get_component_loop_calls();
+  run_with_pin(pin, 2000);
+  EXPECT_EQ(App.get_component_loop_calls() - loop_calls, 0u);
+}
+
+}  // namespace
@@ -0,0 +1,345 @@
+// Renders messages on every device type through the HT16K33 emulator, and checks the display RAM byte for byte and
+// the bus traffic of each update and scroll step against fixed budgets.
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "esphome/core/hal.h"
+#include "host_display.h"
+
+using esphome::App;
+using esphome::ht16k33_char::HT16k33CharComponent;
+
+namespace {
+
+using Ram = std::array<uint8_t, host::HT16k33Emulator::RAM_SIZE>;
+
+struct Expected {
+  const char *message;
+  Ram ram;
+};
+
+// The display RAM of one chip for each message, in the order of DEVICE_TYPES. The '.' and '\'' light a segment of
+// the digit next to them, or a positional dot, depending on the device.
+const Expected EXPECTED[][10] = {
+    // ADAFRUIT_7_SEG_1.2IN
+    {{"12:34", {0x06, 0x00, 0x5B, 0x00, 0x02, 0x00, 0x4F, 0x00, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"A.b'C", {0x77, 0x00, 0x00, 0x00, 0x10, 0x00, 0x7C, 0x00, 0x39, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"HELP", {0x76, 0x00, 0x79, 0x00, 0x00, 0x00, 0x38, 0x00, 0x73, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"..12", {0x00, 0x00, 0x06, 0x00, 0x08, 0x00, 0x5B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"....", {0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"12.:34", {0x06, 0x00, 0x5B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"a.'b", {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"8.8.:8.8.", {0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"1:.2", {0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"12:'3", {0x06, 0x00, 0x5B, 0x00, 0x02, 0x00, 0x00, 0x00, 0x4F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}}},
+    // ADAFRUIT_7_SEG_1.2IN_FLIPPED
+    {{"12:34", {0x74, 0x00, 0x79, 0x00, 0x02, 0x00, 0x5B, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"A.b'C", {0x0F, 0x00, 0x00, 0x00, 0x10, 0x00, 0x67, 0x00, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"HELP", {0x5E, 0x00, 0x07, 0x00, 0x00, 0x00, 0x4F, 0x00, 0x76, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"..12", {0x00, 0x00, 0x5B, 0x00, 0x10, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"....", {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"12.:34", {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5B, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"a.'b", {0x00, 0x00, 0x67, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"8.8.:8.8.", {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x7F, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"1:.2", {0x5B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"12:'3", {0x79, 0x00, 0x00, 0x00, 0x02, 0x00, 0x5B, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}}},
+    // ADAFRUIT_7_SEG_.56IN
+    {{"12:34", {0x06, 0x00, 0x5B, 0x00, 0x02, 0x00, 0x4F, 0x00, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"A.b'C", {0xF7, 0x00, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x39, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"HELP", {0x76, 0x00, 0x79, 0x00, 0x00, 0x00, 0x38, 0x00, 0x73, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"..12", {0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x5B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"....", {0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"12.:34", {0x06, 0x00, 0xDB, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"a.'b", {0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"8.8.:8.8.", {0xFF, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"1:.2", {0x06, 0x00, 0x80, 0x00, 0x00, 0x00, 0x5B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"12:'3", {0x06, 0x00, 0x5B, 0x00, 0x02, 0x00, 0x00, 0x00, 0x4F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}}},
+    // ADAFRUIT_7_SEG_.56IN_FLIPPED
+    {{"12:34", {0x74, 0x00, 0x79, 0x00, 0x02, 0x00, 0x5B, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"A.b'C", {0x8F, 0x00, 0x67, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"HELP", {0x5E, 0x00, 0x07, 0x00, 0x00, 0x00, 0x4F, 0x00, 0x76, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"..12", {0x5B, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"....", {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"12.:34", {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5B, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"a.'b", {0x00, 0x00, 0xE7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"8.8.:8.8.", {0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"1:.2", {0x5B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"12:'3", {0x79, 0x00, 0x00, 0x00, 0x02, 0x00, 0x5B, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}}},
+    // ADAFRUIT_14_SEG
+    {{"12:34", {0x06, 0x00, 0xDB, 0x00, 0x00, 0x12, 0x8F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"A.b'C", {0xF7, 0x40, 0x78, 0x20, 0x00, 0x04, 0x39, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"HELP", {0xF6, 0x00, 0xF9, 0x00, 0x38, 0x00, 0xF3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"..12", {0x00, 0x00, 0x06, 0x00, 0xDB, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"....", {0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"12.:34", {0x06, 0x00, 0xDB, 0x40, 0x00, 0x12, 0x8F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"a.'b", {0x58, 0x50, 0x00, 0x04, 0x78, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"8.8.:8.8.", {0xFF, 0x40, 0xFF, 0x40, 0x00, 0x12, 0xFF, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"1:.2", {0x06, 0x00, 0x00, 0x52, 0xDB, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"12:'3", {0x06, 0x00, 0xDB, 0x00, 0x00, 0x12, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}}},
+    // ADAFRUIT_14_SEG_FLIPPED
+    {{"12:34", {0x79, 0x00, 0x00, 0x12, 0xDB, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"A.b'C", {0x00, 0x08, 0x87, 0x01, 0x00, 0x00, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"HELP", {0xDE, 0x00, 0x07, 0x00, 0xCF, 0x00, 0xF6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"..12", {0xDB, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"....", {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"12.:34", {0x00, 0x12, 0x00, 0x00, 0xDB, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"a.'b", {0x87, 0x01, 0x00, 0x08, 0x00, 0x00, 0x83, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"8.8.:8.8.", {0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"1:.2", {0xDB, 0x00, 0x00, 0x00, 0x00, 0x12, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"12:'3", {0x00, 0x08, 0x00, 0x12, 0xDB, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}}},
+    // SPARKFUN_14_SEG
+    {{"12:34", {0xAA, 0x00, 0x0B, 0x00, 0x49, 0x00, 0x0A, 0x00, 0x02, 0x00, 0x40, 0x00, 0x02, 0x00, 0x00, 0x00}},
+     {"A.b'C", {0x11, 0x00, 0x01, 0x00, 0x01, 0x00, 0x84, 0x00, 0x45, 0x00, 0x05, 0x00, 0x05, 0x00, 0x00, 0x00}},
+     {"HELP", {0xBA, 0x00, 0x09, 0x00, 0x01, 0x00, 0x06, 0x00, 0x0F, 0x00, 0x0F, 0x00, 0x0B, 0x00, 0x00, 0x00}},
+     {"..12", {0x88, 0x00, 0x0C, 0x00, 0x04, 0x00, 0x08, 0x00, 0x08, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00}},
+     {"....", {0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"12.:34", {0x22, 0x00, 0x03, 0x00, 0x81, 0x00, 0x02, 0x00, 0x02, 0x00, 0x80, 0x00, 0x02, 0x00, 0x00, 0x00}},
+     {"a.'b", {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0x00, 0x89, 0x00, 0x18, 0x00, 0x09, 0x00, 0x00, 0x00}},
+     {"8.8.:8.8.", {0x55, 0x00, 0x05, 0x01, 0x85, 0x00, 0x05, 0x00, 0x05, 0x00, 0x85, 0x00, 0x05, 0x00, 0x00, 0x00}},
+     {"1:.2", {0x88, 0x00, 0x09, 0x00, 0x21, 0x00, 0x08, 0x00, 0x08, 0x00, 0x20, 0x00, 0x08, 0x00, 0x00, 0x00}},
+     {"12:'3", {0x22, 0x00, 0x03, 0x00, 0x41, 0x00, 0x82, 0x00, 0x02, 0x00, 0x40, 0x00, 0x02, 0x00, 0x00, 0x00}}},
+    // SPARKFUN_14_SEG_FLIPPED
+    {{"12:34", {0x45, 0x00, 0x04, 0x00, 0x20, 0x00, 0x05, 0x00, 0x0D, 0x00, 0x29, 0x00, 0x05, 0x00, 0x00, 0x00}},
+     {"A.b'C", {0xA2, 0x00, 0x2A, 0x00, 0x0A, 0x00, 0x08, 0x00, 0x08, 0x00, 0x08, 0x00, 0x18, 0x00, 0x00, 0x00}},
+     {"HELP", {0xD6, 0x00, 0x0F, 0x00, 0x0F, 0x00, 0x05, 0x00, 0x09, 0x00, 0x08, 0x00, 0x0D, 0x00, 0x00, 0x00}},
+     {"..12", {0x11, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x03, 0x00, 0x02, 0x00, 0x01, 0x00, 0x00, 0x00}},
+     {"....", {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+     {"12.:34", {0x44, 0x00, 0x04, 0x00, 0x10, 0x00, 0x04, 0x00, 0x0C, 0x00, 0x18, 0x00, 0x04, 0x00, 0x00, 0x00}},
+     {"a.'b", {0x99, 0x00, 0x19, 0x00, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00}},
+     {"8.8.:8.8.", {0xAA, 0x00, 0x0A, 0x00, 0x0A, 0x00, 0x0A, 0x00, 0x0A, 0x00, 0x0A, 0x00, 0x0A, 0x00, 0x00, 0x00}},
+     {"1:.2", {0x11, 0x00, 0x01, 0x00, 0x40, 0x00, 0x01, 0x00, 0x09, 0x00, 0x48, 0x00, 0x01, 0x00, 0x00, 0x00}},
+     {"12:'3", {0x44, 0x00, 0x04, 0x00, 0x20, 0x00, 0x04, 0x00, 0x0C, 0x00, 0x28, 0x00, 0x14, 0x00, 0x00, 0x00}}},
+};
+
+// The most bytes and transactions that a change of every digit may cost on one chip, in the order of DEVICE_TYPES.
+// Only the changed spans of the display RAM are sent:
+//  -The 7 segment displays change the bytes of digits 0-1 and 2-3, which are split by the colon byte, so two writes.
+//  -The Adafruit 14 segment displays change bytes 0-7 in one write.
+//  -The Sparkfun displays light each segment of every digit through the same 7 bytes, so a change of some digits can
+//   leave gaps of unchanged bytes.
+struct Budget {
+  uint32_t bytes;
+  uint32_t transactions;
+};
+const Budget BUDGETS[] = {{8, 2}, {8, 2}, {8, 2}, {8, 2}, {9, 1}, {9, 1}, {14, 3}, {14, 3}};
+
+// A long message that uses characters that every font has.
+std::string long_message(size_t length) {
+  static const char CHARS[] = "0123456789 -AbCdEF";
+  std::string message;
+  for (size_t i = 0; i < length; i++) {
+    message += CHARS[i % (sizeof(CHARS) - 1)];
+  }
+  return message;
+}
+
+class RenderTest : public ::testing::TestWithParam<size_t> {
+ protected:
+  const host::DeviceType &type() const { return host::DEVICE_TYPES[GetParam()]; }
+  const Budget &budget() const { return BUDGETS[GetParam()]; }
+};
+
+TEST_P(RenderTest, SetupWritesControlRegisters) {
+  host::HostDisplay display(this->type(), 3);
+  display.setup();
+
+  for (auto *chip : display.chips) {
+    EXPECT_TRUE(chip->oscillator());
+    EXPECT_TRUE(chip->display_on());
+    EXPECT_EQ(chip->blink(), 0);
+    EXPECT_EQ(chip->dimming(), 14);
+    EXPECT_EQ(chip->system_setup_writes(), 1u);
+    EXPECT_EQ(chip->display_setup_writes(), 1u);
+    EXPECT_EQ(chip->dimming_writes(), 1u);
+  }
+}
+
+TEST_P(RenderTest, RendersMessagesByteExact) {
+  for (const auto &expected : EXPECTED[GetParam()]) {
+    host::HostDisplay display(this->type(), 1);
+    std::string message = expected.message;
+    display->set_writer([message](HT16k33CharComponent &it) { it.print(0, true, message.c_str()); });
+    display.setup();
+
+    auto ram = display.ram();
+    EXPECT_TRUE(std::equal(ram.begin(), ram.end(), expected.ram.begin())) << "message \"" << expected.message << "\"";
+  }
+}
+
+TEST_P(RenderTest, MessageContinuesOnTheNextChip) {
+  host::HostDisplay chain(this->type(), 3);
+  chain->set_writer([](HT16k33CharComponent &it) { it.print(0, true, "HELPHELPHELP"); });
+  chain.setup();
+
+  const Ram &expected = EXPECTED[GetParam()][2].ram;
+  for (size_t chip = 0; chip < 3; chip++) {
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), chain.chips[chip]->ram())) << "chip " << chip;
+  }
+}
+
+TEST_P(RenderTest, UnchangedUpdatesWriteNothing) {
+  host::HostDisplay display(this->type(), 7);
+  display->set_update_interval(100);
+  display->set_writer([](HT16k33CharComponent &it) { it.printf(0, true, "%02d:%02d", 12, 34); });
+  display.setup();
+
+  display.bus.reset_counters();
+  App.run_for(2000);
+  EXPECT_EQ(display.bus.transactions(), 0u);
+  EXPECT_EQ(display.bus.bytes(), 0u);
+}
+
+TEST_P(RenderTest, ClearingPastTheEndBlanksTheDisplay) {
+  // Each print clears the buffer, then has no room at start_pos. The display goes blank all the same.
+  for (int writer = 0; writer < 3; writer++) {
+    bool blank = false;
+    host::HostDisplay display(this->type(), 1, 16);
+    display->set_update_interval(100);
+    display->set_writer([&blank, writer](HT16k33CharComponent &it) {
+      if (!blank) {
+        it.print(0, true, "HELP");
+      } else if (writer == 0) {
+        it.print(16, true, "HELP");
+      } else if (writer == 1) {
+        it.printf(16, true, "%d", 1234);
+      } else {
+        it.strftime(16, true, "%H%M", esphome::ESPTime{});
+      }
+    });
+    display.setup();
+    const Ram &expected = EXPECTED[GetParam()][2].ram;
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), display.chips[0]->ram())) << "writer " << writer;
+
+    blank = true;
+    App.run_for(200);
+    auto ram = display.ram();
+    EXPECT_TRUE(std::all_of(ram.begin(), ram.end(), [](uint8_t byte) { return byte == 0; })) << "writer " << writer;
+  }
+}
+
+TEST_P(RenderTest, ChangedDigitWritesOnlyItsChip) {
+  int value = 0;
+  host::HostDisplay display(this->type(), 7);
+  display->set_update_interval(100);
+  // The counter is on the last chip, the first six chips are static.
+  display->set_writer([&value](HT16k33CharComponent &it) {
+    it.print(0, true, "000000000000000000000000");
+    it.printf(24, false, "%04d", value);
+  });
+  display.setup();
+
+  for (int step = 0; step < 200; step++) {
+    value += 7;
+    display.bus.reset_counters();
+    uint32_t static_writes = 0;
+    for (size_t chip = 0; chip < 6; chip++) {
+      static_writes += display.chips[chip]->ram_writes();
+    }
+    App.run_for(100);
+    for (size_t chip = 0; chip < 6; chip++) {
+      static_writes -= display.chips[chip]->ram_writes();
+    }
+    EXPECT_EQ(static_writes, 0u) << "step " << step;
+    EXPECT_GE(display.bus.transactions(), 1u) << "step " << step;
+    EXPECT_LE(display.bus.transactions(), this->budget().transactions) << "step " << step;
+    EXPECT_LE(display.bus.bytes(), this->budget().bytes) << "step " << step;
+  }
+}
+
+TEST_P(RenderTest, ScrollStepTrafficIsBounded) {
+  const uint8_t num_chips = 7;
+  std::string message = long_message(255);
+  host::HostDisplay display(this->type(), num_chips, 256);
+  display->set_update_interval(60000);
+  display->set_scroll(true);
+  display->set_continuous(true);
+  display->set_scroll_speed(100);
+  display->set_scroll_delay(100);
+  display->set_writer([message](HT16k33CharComponent &it) { it.print(0, true, message.c_str()); });
+  display.setup(0);
+  App.run_for(300);
+
+  uint32_t steps = 0;
+  for (int pass = 0; pass < 1000; pass++) {
+    uint32_t steps_before = display->get_stats().scroll_steps;
+    display.bus.reset_counters();
+    App.loop_once();
+    if (display->get_stats().scroll_steps == steps_before) {
+      EXPECT_EQ(display.bus.transactions(), 0u) << "pass " << pass;
+      continue;
+    }
+    steps++;
+    EXPECT_LE(display.bus.transactions(), num_chips * this->budget().transactions) << "pass " << pass;
+    EXPECT_LE(display.bus.bytes(), num_chips * this->budget().bytes) << "pass " << pass;
+  }
+  EXPECT_GT(steps, 100u);
+}
+
+TEST_P(RenderTest, ScrollShowsEveryStepInOrder) {
+  host::HostDisplay display(this->type(), 1);
+  display->set_update_interval(60000);
+  display->set_scroll(true);
+  display->set_scroll_speed(100);
+  display->set_scroll_delay(100);
+  display->set_scroll_dwell(100);
+  display->set_writer([](HT16k33CharComponent &it) { it.print(0, true, "HELP12:34"); });
+  display.setup(0);
+
+  // "HELP" is shown first, and "12:34" four steps later. Each step is written once.
+  std::vector<std::vector<uint8_t>> shown;
+  while (shown.size() < 5) {
+    uint32_t writes = display.chips[0]->ram_writes();
+    App.loop_once();
+    if (display.chips[0]->ram_writes() == writes) {
+      continue;
+    }
+    EXPECT_LE(display.chips[0]->ram_writes() - writes, this->budget().transactions);
+    shown.push_back(display.ram());
+    ASSERT_LT(esphome::millis(), 1000u);
+  }
+  const Ram &help = EXPECTED[GetParam()][2].ram;
+  const Ram &clock = EXPECTED[GetParam()][0].ram;
+  EXPECT_TRUE(std::equal(help.begin(), help.end(), shown[0].begin()));
+  EXPECT_TRUE(std::equal(clock.begin(), clock.end(), shown[4].begin()));
+}
+
+TEST_P(RenderTest, BrightnessAndBlinkOnlyWriteTheirRegisters) {
+  host::HostDisplay display(this->type(), 3);
+  display->set_update_interval(100);
+  display->set_writer([](HT16k33CharComponent &it) { it.print(0, true, "HELP"); });
+  display.setup();
+
+  auto ram = display.ram();
+  display.bus.reset_counters();
+  display->brightness(5);
+  display->set_blink(2);
+  App.run_for(200);
+
+  for (auto *chip : display.chips) {
+    EXPECT_EQ(chip->dimming(), 4);
+    EXPECT_EQ(chip->blink(), 2);
+  }
+  // One dimming and one display setup write for each chip.
+  EXPECT_EQ(display.bus.transactions(), 2u * 3u);
+  EXPECT_EQ(display.bus.bytes(), 2u * 3u);
+  EXPECT_EQ(display.ram(), ram);
+
+  display.bus.reset_counters();
+  display->display_off(true);
+  App.run_for(200);
+  for (auto *chip : display.chips) {
+    EXPECT_FALSE(chip->display_on());
+  }
+  EXPECT_EQ(display.bus.transactions(), 3u);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllDevices, RenderTest, ::testing::Range<size_t>(0, host::NUM_DEVICE_TYPES),
+                         [](const ::testing::TestParamInfo<size_t> &info) {
+                           return host::test_name(host::DEVICE_TYPES[info.param]);
+                         });
+
+}  // namespace
@@ -0,0 +1,124 @@
+// Checks how the message scrolls when it is printed again, and when a transition shows a new message.
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "esphome/core/hal.h"
+#include "host_display.h"
+
+using esphome::App;
+using esphome::ht16k33_char::HT16k33CharComponent;
+
+namespace {
+
+using Ram = std::vector<uint8_t>;
+
+const char *const MESSAGE = "0123456789AbCdEF";
+
+// The display RAM of one chip of the first device type for each scroll position of MESSAGE, in continuous mode.
+std::vector<Ram> scroll_positions() {
+  std::string message = MESSAGE;
+  std::string twice = message + message;
+  std::vector<Ram> positions;
+  for (size_t position = 0; position < message.size(); position++) {
+    host::HostDisplay display(host::DEVICE_TYPES[0], 1);
+    std::string text = twice.substr(position, 4);
+    display->set_writer([text](HT16k33CharComponent &it) { it.print(0, true, text.c_str()); });
+    display.setup();
+    positions.push_back(display.ram());
+  }
+  return positions;
+}
+
+// The scroll position that the display RAM shows, or -1.
+int position_of(const std::vector<Ram> &positions, const Ram &ram) {
+  for (size_t position = 0; position < positions.size(); position++) {
+    if (positions[position] == ram) {
+      return position;
+    }
+  }
+  return -1;
+}
+
+TEST(ScrollTest, TransitionHoldsTheScrollPosition) {
+  std::vector<Ram> positions = scroll_positions();
+
+  host::HostDisplay display(host::DEVICE_TYPES[0], 1);
+  std::string message(16, '-');
+  display->set_update_interval(1000);
+  display->set_scroll(true);
+  display->set_scroll_delay(50);
+  display->set_continuous(true);
+  display->set_scroll_speed(100);
+  display->set_transition(esphome::ht16k33_char::HT16K33_TRANSITION_FLASH);
+  display->set_transition_duration(1000);
+  display->set_writer([&message](HT16k33CharComponent &it) { it.print(0, true, message.c_str()); });
+  display.setup(1500);
+  ASSERT_EQ(display.chips[0]->blink(), 0);
+
+  // The next update prints a message of the same length while the display scrolls. The next scroll step shows it,
+  // with a transition.
+  message = MESSAGE;
+  for (int loop = 0; (loop < 100) && (display.chips[0]->blink() == 0); loop++) {
+    App.loop_once();
+  }
+  ASSERT_NE(display.chips[0]->blink(), 0);
+  uint32_t transition_start = esphome::millis();
+  int held = position_of(positions, display.ram());
+  ASSERT_GE(held, 0);
+
+  // The transition shows the message where it started, for the whole transition.
+  while (esphome::millis() < transition_start + 950) {
+    App.loop_once();
+    ASSERT_EQ(position_of(positions, display.ram()), held) << "at " << (esphome::millis() - transition_start) << " ms";
+  }
+
+  // Then the message scrolls on from there, one step at a time.
+  std::vector<int> steps;
+  for (uint32_t time = 0; time < 500; time += 16) {
+    App.loop_once();
+    int position = position_of(positions, display.ram());
+    if (steps.empty() || (steps.back() != position)) {
+      steps.push_back(position);
+    }
+  }
+  ASSERT_GE(steps.size(), 4u);
+  for (size_t step = 0; step < steps.size(); step++) {
+    EXPECT_EQ(steps[step], (held + step) % 16) << "step " << step;
+  }
+}
+
+TEST(ScrollTest, MessageOfSeveralPrintsKeepsScrolling) {
+  std::vector<Ram> positions = scroll_positions();
+
+  host::HostDisplay display(host::DEVICE_TYPES[0], 1);
+  display->set_update_interval(100);
+  display->set_scroll(true);
+  display->set_scroll_delay(50);
+  display->set_continuous(true);
+  display->set_scroll_speed(100);
+  // The first print makes the message shorter for a moment. The message is the same once the lambda is done.
+  display->set_writer([](HT16k33CharComponent &it) {
+    it.print(0, true, "0123456789");
+    it.print(10, false, "AbCdEF");
+  });
+  display.setup(200);
+
+  std::vector<int> steps;
+  for (uint32_t time = 0; time < 2000; time += 16) {
+    App.loop_once();
+    int position = position_of(positions, display.ram());
+    ASSERT_GE(position, 0) << "at " << time << " ms";
+    if (steps.empty() || (steps.back() != position)) {
+      steps.push_back(position);
+    }
+  }
+  ASSERT_GE(steps.size(), 16u);
+  for (size_t step = 1; step < steps.size(); step++) {
+    EXPECT_EQ(steps[step], (steps[step - 1] + 1) % 16) << "step " << step;
+  }
+}
+
+}  // namespace
@@ -0,0 +1,88 @@
+// Checks how a display chain that is split over two buses is flushed: the buses take turns one write at a time, and
+// every chip gets its frame. ESPHome I2C writes block until the transfer is done, so taking turns does not make the
+// buses transfer at the same time. The frame latency on buses that do is measured by bench.cpp.
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "host_display.h"
+
+using esphome::App;
+using esphome::ht16k33_char::HT16k33CharComponent;
+
+namespace {
+
+// An emulated bus that records the order of the display writes on all buses that share the same order.
+class OrderedBus : public host::EmulatedBus {
+ public:
+  OrderedBus(uint8_t index, std::vector<uint8_t> *order) : index_(index), order_(order) {}
+
+  esphome::i2c::ErrorCode write(uint8_t address, const uint8_t *buffer, size_t len, bool stop) override {
+    if ((len > 0) && (buffer[0] == esphome::ht16k33_char::HT16K33_DISPLAY_DATA_ADDRESS)) {
+      this->order_->push_back(this->index_);
+    }
+    return host::EmulatedBus::write(address, buffer, len, stop);
+  }
+  using host::EmulatedBus::write;
+
+ protected:
+  uint8_t index_;
+  std::vector<uint8_t> *order_;
+};
+
+/***********************************
+ *A chain of 6 chips. The last 3 chips are on a second bus.
+ ************************************/
+class SplitChain {
+ public:
+  SplitChain() {
+    App.reset();
+    const host::DeviceType &type = host::DEVICE_TYPES[0];
+    this->component.reset(type.create());
+    this->component->set_font(type.font);
+    this->component->set_buffer_max_size(64);
+    this->component->set_i2c_bus(&this->buses[0]);
+    this->component->set_i2c_address(0x70);
+    this->chips.push_back(this->buses[0].add_chip(0x70));
+    for (uint8_t chip = 1; chip < 6; chip++) {
+      uint8_t bus = (chip >= 3) ? 1 : 0;
+      auto device = std::make_unique<esphome::i2c::I2CDevice>();
+      device->set_i2c_bus(&this->buses[bus]);
+      device->set_i2c_address(0x70 + chip);
+      this->component->add_secondary_display(device.get(), esphome::ht16k33_char::HT16K33_NO_CHANNEL, bus);
+      this->secondary.push_back(std::move(device));
+      this->chips.push_back(this->buses[bus].add_chip(0x70 + chip));
+    }
+    App.register_component(this->component.get());
+    App.setup();
+    App.run_for(100);
+    this->order.clear();
+  }
+  ~SplitChain() { App.reset(); }
+
+  std::vector<uint8_t> order;
+  OrderedBus buses[2]{{0, &this->order}, {1, &this->order}};
+  std::unique_ptr<HT16k33CharComponent> component;
+  std::vector<std::unique_ptr<esphome::i2c::I2CDevice>> secondary;
+  std::vector<host::HT16k33Emulator *> chips;
+};
+
+TEST(SplitBusTest, SplitChainTakesTurnsBetweenBuses) {
+  SplitChain chain;
+  chain.component->print(0, true, "888888888888888888888888");
+  chain.component->update_display();
+  App.run_for(100);
+
+  // Each chip gets its frame, and the buses take turns while both have a write left.
+  ASSERT_EQ(chain.order.size(), 6u);
+  EXPECT_EQ(chain.order, (std::vector<uint8_t>{0, 1, 0, 1, 0, 1}));
+  EXPECT_EQ(chain.chips[0]->ram()[0], 0x7F);
+  for (auto *chip : chain.chips) {
+    EXPECT_TRUE(std::equal(chip->ram(), chip->ram() + host::HT16k33Emulator::RAM_SIZE, chain.chips[0]->ram()));
+  }
+}
+
+}  // namespace